@@ -25,6 +25,8 @@
 #include "kis_transaction.h"
 #include <KoCompositeOpRegistry.h>
 #include "kis_datamanager.h"
+#include "kis_pixel_selection.h"
+#include "kis_selection_filters.h"
 
 
 #define NUM_CYCLES 50
@@ -290,4 +292,51 @@ void KisFilterSelectionsBenchmark::testBitBltSelections(int num)
         dbgKrita << "bitBlt with sel:\t\t\t" << avTime;
 }
 
+void KisFilterSelectionsBenchmark::testSelectionFilter(KisSelectionFilter *filter, const QString &name)
+{
+    KisPixelSelectionSP srcSelection = m_selection->pixelSelection();
+    const QRect rect = filter->changeRect(srcSelection->selectedExactRect());
+
+    KisTimeCounter timer;
+
+    timer.restart();
+    for (int i = 0; i < NUM_CYCLES; i++) {
+        KisPixelSelectionSP pixelSelection = new KisPixelSelection(*srcSelection);
+        filter->process(pixelSelection, rect);
+    }
+    double avTime = double(timer.elapsed()) / NUM_CYCLES;
+
+    dbgKrita << name << ":\t\t\t" << avTime;
+}
+
+void KisFilterSelectionsBenchmark::testSelectionFilters()
+{
+    initSelection();
+
+    for (int pass = 0; pass < 2; pass++) {
+        if (pass == 1) {
+            /**
+             * The default selection has a semi-selected area, which
+             * makes the filters take the grayscale path. Remove it to
+             * benchmark the distance transform based one.
+             */
+            m_selection->pixelSelection()->dataManager()->clear(205, 105, 50, 50, quint8(0));
+            dbgKrita << "Binary selection:";
+        } else {
+            dbgKrita << "Grayscale selection:";
+        }
+
+        Q_FOREACH (int radius, QList<int>() << 10 << 100) {
+            KisGrowSelectionFilter grow(radius, radius);
+            testSelectionFilter(&grow, QString("Grow %1").arg(radius));
+
+            KisShrinkSelectionFilter shrink(radius, radius, false);
+            testSelectionFilter(&shrink, QString("Shrink %1").arg(radius));
+
+            KisBorderSelectionFilter border(radius, radius);
+            testSelectionFilter(&border, QString("Border %1").arg(radius));
+        }
+    }
+}
+
 QTEST_MAIN(KisFilterSelectionsBenchmark)
@@ -26,6 +26,8 @@
 #include "filter/kis_filter_registry.h"
 #include "kis_processing_information.h"
 
+class KisSelectionFilter;
+
 
 class KisFilterSelectionsBenchmark : public QObject
 {
@@ -33,6 +35,7 @@ class KisFilterSelectionsBenchmark : public QObject
 private Q_SLOTS:
 
     void testAll();
+    void testSelectionFilters();
 
 private:
     void initSelection();
@@ -43,6 +46,7 @@ private:
     void testGoodSelections(int num);
     void testBitBltWOSelections(int num);
     void testBitBltSelections(int num);
+    void testSelectionFilter(KisSelectionFilter *filter, const QString &name);
 private:
     KisSelectionSP m_selection;
     KisPaintDeviceSP m_device;
@@ -50,15 +50,8 @@ void KisColorTransformationFilter::processImpl(KisPaintDeviceSP device,
     Q_ASSERT(!device.isNull());
 
     const KoColorSpace * cs = device->colorSpace();
-    KoColorTransformation * colorTransformation = 0;
-    // Ew, casting
-    KisColorTransformationConfigurationSP colorTransformationConfiguration(dynamic_cast<KisColorTransformationConfiguration*>(const_cast<KisFilterConfiguration*>(config.data())));
-    if (colorTransformationConfiguration) {
-        colorTransformation = colorTransformationConfiguration->colorTransformation(cs, this);
-    }
-    else {
-        colorTransformation = createTransformation(cs, config);
-    }
+    bool isShared = false;
+    KoColorTransformation * colorTransformation = fetchTransformation(cs, config, &isShared);
     if (!colorTransformation) return;
 
     KisSequentialIteratorProgress it(device, applyRect, progressUpdater);
@@ -69,12 +62,23 @@ void KisColorTransformationFilter::processImpl(KisPaintDeviceSP device,
         colorTransformation->transform(it.oldRawData(), it.rawData(), conseq);
     }
 
-    if (!colorTransformationConfiguration) {
+    if (!isShared) {
         delete colorTransformation;
     }
 
 }
 
+KoColorTransformation* KisColorTransformationFilter::fetchTransformation(const KoColorSpace* cs, const KisFilterConfigurationSP config, bool *isShared) const
+{
+    // Ew, casting
+    KisColorTransformationConfigurationSP colorTransformationConfiguration(dynamic_cast<KisColorTransformationConfiguration*>(const_cast<KisFilterConfiguration*>(config.data())));
+    *isShared = !colorTransformationConfiguration.isNull();
+
+    return colorTransformationConfiguration ?
+        colorTransformationConfiguration->colorTransformation(cs, this) :
+        createTransformation(cs, config);
+}
+
 KisFilterConfigurationSP  KisColorTransformationFilter::factoryConfiguration() const
 {
     return new KisColorTransformationConfiguration(id(), 0);
@@ -42,6 +42,14 @@ public:
      */
     virtual KoColorTransformation* createTransformation(const KoColorSpace* cs, const KisFilterConfigurationSP config) const = 0;
 
+    /**
+     * Fetch the color transformation for \p config. If the configuration
+     * caches its transformations, the cached one is returned and \p isShared
+     * is set to true. Otherwise a new transformation is created and the
+     * caller takes ownership of it.
+     */
+    KoColorTransformation* fetchTransformation(const KoColorSpace* cs, const KisFilterConfigurationSP config, bool *isShared) const;
+
     KisFilterConfigurationSP factoryConfiguration() const override;
 };
 
@@ -34,6 +34,11 @@
 #include "kis_busy_progress_indicator.h"
 #include "kis_transaction.h"
 #include "kis_painter.h"
+#include "kis_pixel_selection.h"
+#include "kis_sequential_iterator.h"
+#include "filter/kis_color_transformation_filter.h"
+#include <KoColor.h>
+#include <KoColorSpace.h>
 
 KisFilterMask::KisFilterMask()
     : KisEffectMask(),
@@ -180,3 +185,53 @@ QRect KisFilterMask::needRect(const QRect& rect, PositionToFilthy pos) const
     return filter->neededRect(rect, filterConfig.data(), lod);
 }
 
+namespace {
+
+bool isFullySelected(KisSelectionSP selection, const QRect &rect)
+{
+    KisPixelSelectionSP pixelSelection = selection->projection();
+
+    if (*pixelSelection->defaultPixel().data() == MAX_SELECTED &&
+        (pixelSelection->exactBounds() & rect).isEmpty()) {
+
+        return true;
+    }
+
+    KisSequentialConstIterator it(pixelSelection, rect);
+
+    int conseq = it.nConseqPixels();
+    while (it.nextPixels(conseq)) {
+        conseq = it.nConseqPixels();
+
+        const quint8 *selectionPtr = it.rawDataConst();
+        for (int i = 0; i < conseq; i++) {
+            if (selectionPtr[i] != MAX_SELECTED) return false;
+        }
+    }
+
+    return true;
+}
+
+}
+
+const KisColorTransformationFilter* KisFilterMask::fusableColorFilter(KisPaintDeviceSP device, const QRect &rect) const
+{
+    KisSelectionSP selection = this->selection();
+    if (selection && !isFullySelected(selection, rect)) return 0;
+
+    KisFilterConfigurationSP filterConfig = filter();
+    if (!filterConfig) return 0;
+
+    /**
+     * KisFilter::process() doesn't work in place in such color
+     * spaces, so leave them to the usual path
+     */
+    if (device->colorSpace() != device->compositionSourceColorSpace() &&
+        *device->colorSpace() != *device->compositionSourceColorSpace()) {
+
+        return 0;
+    }
+
+    KisFilterSP filter = KisFilterRegistry::instance()->value(filterConfig->name());
+    return dynamic_cast<const KisColorTransformationFilter*>(filter.data());
+}
@@ -24,6 +24,7 @@
 #include "kis_node_filter_interface.h"
 
 class KisFilterConfiguration;
+class KisColorTransformationFilter;
 
 /**
    An filter mask is a single channel mask that applies a particular
@@ -65,6 +66,19 @@ public:
 
     QRect changeRect(const QRect &rect, PositionToFilthy pos = N_FILTHY) const override;
     QRect needRect(const QRect &rect, PositionToFilthy pos = N_FILTHY) const override;
+
+    /**
+     * Returns the filter of the mask if the mask is a plain per-pixel
+     * color adjustment of the whole \p rect, that is, if it can be
+     * applied in place on \p device together with its neighbours.
+     * Otherwise returns null.
+     *
+     * A selection that selects every pixel of \p rect is treated as no
+     * selection at all. The masks created in the UI and loaded from .kra
+     * always have a selection, usually with a fully selected default
+     * pixel.
+     */
+    const KisColorTransformationFilter* fusableColorFilter(KisPaintDeviceSP device, const QRect &rect) const;
 };
 
 #endif //_KIS_FILTER_MASK_
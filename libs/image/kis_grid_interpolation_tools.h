@@ -23,6 +23,9 @@
 #include <algorithm>
 
 #include <QImage>
+#include <QScopedPointer>
+
+#include <KoColorSpaceConstants.h>
 
 #include "kis_algebra_2d.h"
 #include "kis_four_point_interpolator_forward.h"
@@ -174,10 +177,20 @@ void processGrid(ProcessPolygon &polygonOp, ForwardTransform &transformOp,
     processGrid(cellOp, srcBounds, pixelPrecision);
 }
 
+/**
+ * Maps the source device into the destination device polygon by polygon.
+ *
+ * If \p writtenMaskDev is set, every pixel written into the destination
+ * is also marked in this (alpha8) device. That is used for splitting the
+ * processing into a set of independent jobs, whose results are then
+ * merged in the same order as if they were processed sequentially.
+ */
 struct PaintDevicePolygonOp
 {
-    PaintDevicePolygonOp(KisPaintDeviceSP srcDev, KisPaintDeviceSP dstDev)
-        : m_srcDev(srcDev), m_dstDev(dstDev) {}
+    PaintDevicePolygonOp(KisPaintDeviceSP srcDev, KisPaintDeviceSP dstDev,
+                         KisPaintDeviceSP writtenMaskDev = 0)
+        : m_srcDev(srcDev), m_dstDev(dstDev), m_writtenMaskDev(writtenMaskDev),
+          m_srcAcc(srcDev->createRandomSubAccessor()) {}
 
     void operator() (const QPolygonF &srcPolygon, const QPolygonF &dstPolygon) {
         this->operator() (srcPolygon, dstPolygon, dstPolygon);
@@ -188,7 +201,12 @@ struct PaintDevicePolygonOp
         if (boundRect.isEmpty()) return;
 
         KisSequentialIterator dstIt(m_dstDev, boundRect);
-        KisRandomSubAccessorSP srcAcc = m_srcDev->createRandomSubAccessor();
+        KisRandomSubAccessorSP srcAcc = m_srcAcc;
+
+        QScopedPointer<KisSequentialIterator> maskIt;
+        if (m_writtenMaskDev) {
+            maskIt.reset(new KisSequentialIterator(m_writtenMaskDev, boundRect));
+        }
 
         KisFourPointInterpolatorBackward interp(srcPolygon, dstPolygon);
 
@@ -196,6 +214,10 @@ struct PaintDevicePolygonOp
         interp.setY(y);
 
         while (dstIt.nextPixel()) {
+            if (maskIt) {
+                maskIt->nextPixel();
+            }
+
             int newY = dstIt.y();
 
             if (y != newY) {
@@ -219,6 +241,10 @@ struct PaintDevicePolygonOp
 
                 srcAcc->moveTo(dstPoint);
                 srcAcc->sampledOldRawData(dstIt.rawData());
+
+                if (maskIt) {
+                    *maskIt->rawData() = OPACITY_OPAQUE_U8;
+                }
             }
 
         }
@@ -227,6 +253,8 @@ struct PaintDevicePolygonOp
 
     KisPaintDeviceSP m_srcDev;
     KisPaintDeviceSP m_dstDev;
+    KisPaintDeviceSP m_writtenMaskDev;
+    KisRandomSubAccessorSP m_srcAcc;
 };
 
 struct QImagePolygonOp
@@ -551,6 +579,9 @@ inline void adjustAlignedPolygon(QPolygonF &polygon)
     polygon[3] += p3;
 }
 
+/**
+ * Iterates through the cell rows [\p firstRow, \p lastRow] of the grid
+ */
 template <template <class PolygonOp, class IndexesOp> class IncompletePolygonPolicy,
           class PolygonOp,
           class IndexesOp>
@@ -558,11 +589,12 @@ void iterateThroughGrid(PolygonOp &polygonOp,
                         IndexesOp &indexesOp,
                         const QSize &gridSize,
                         const QVector<QPointF> &originalPoints,
-                        const QVector<QPointF> &transformedPoints)
+                        const QVector<QPointF> &transformedPoints,
+                        int firstRow, int lastRow)
 {
     QVector<int> polygonPoints(4);
 
-    for (int row = 0; row < gridSize.height() - 1; row++) {
+    for (int row = firstRow; row <= lastRow; row++) {
         for (int col = 0; col < gridSize.width() - 1; col++) {
             int numExistingPoints = 0;
 
@@ -595,6 +627,22 @@ void iterateThroughGrid(PolygonOp &polygonOp,
     }
 }
 
+template <template <class PolygonOp, class IndexesOp> class IncompletePolygonPolicy,
+          class PolygonOp,
+          class IndexesOp>
+void iterateThroughGrid(PolygonOp &polygonOp,
+                        IndexesOp &indexesOp,
+                        const QSize &gridSize,
+                        const QVector<QPointF> &originalPoints,
+                        const QVector<QPointF> &transformedPoints)
+{
+    iterateThroughGrid<IncompletePolygonPolicy>(polygonOp, indexesOp,
+                                                gridSize,
+                                                originalPoints,
+                                                transformedPoints,
+                                                0, gridSize.height() - 2);
+}
+
 }
 
 #endif /* __KIS_GRID_INTERPOLATION_TOOLS_H */
@@ -115,6 +115,13 @@ public:
      * Makes a copy of the image with all the layers. If possible, shallow
      * copies of the layers are made.
      *
+     * The pixel data of the copied devices is not duplicated: the
+     * tiles of the clone reference the same tile data as the original
+     * ones and are detached only when either of the images writes into
+     * them. So the clone costs only the node metadata until the clone
+     * starts regenerating its projections, which makes it cheap enough
+     * for background savers and frame rendering workers.
+     *
      * \p exactCopy shows if the copied image should look *exactly* the same as
      * the other one (according to it's .kra xml representation). It means that
      * the layers will have the same UUID keys and, therefore, you are not
@@ -43,6 +43,13 @@
 #include "kis_painter.h"
 #include "kis_mask.h"
 #include "kis_effect_mask.h"
+#include "kis_filter_mask.h"
+#include "kis_sequential_iterator.h"
+#include "kis_busy_progress_indicator.h"
+#include "filter/kis_filter_configuration.h"
+#include "filter/kis_filter_registry.h"
+#include "filter/kis_color_transformation_filter.h"
+#include <KoColorTransformation.h>
 #include "kis_selection_mask.h"
 #include "kis_meta_data_store.h"
 #include "kis_selection.h"
@@ -699,6 +706,62 @@ KisNode::PositionToFilthy calculatePositionToFilthy(KisNodeSP nodeInQuestion,
     return KisNode::N_BELOW_FILTHY;
 }
 
+namespace {
+
+const KisColorTransformationFilter* fusableColorFilter(KisEffectMaskSP mask, KisPaintDeviceSP device, const QRect &rect)
+{
+    const KisFilterMask *filterMask = dynamic_cast<const KisFilterMask*>(mask.data());
+    return filterMask ? filterMask->fusableColorFilter(device, rect) : 0;
+}
+
+void applyFusedColorMasks(const QList<KisEffectMaskSP> &masks, KisPaintDeviceSP device, const QRect &rect)
+{
+    const KoColorSpace *cs = device->colorSpace();
+
+    QVector<KoColorTransformation*> transformations;
+    QVector<KoColorTransformation*> ownedTransformations;
+
+    Q_FOREACH (const KisEffectMaskSP &mask, masks) {
+        const KisFilterMask *filterMask = dynamic_cast<const KisFilterMask*>(mask.data());
+        const KisColorTransformationFilter *filter = fusableColorFilter(mask, device, rect);
+        KIS_SAFE_ASSERT_RECOVER(filterMask && filter) { continue; }
+
+        KisBusyProgressIndicator *indicator = filterMask->busyProgressIndicator();
+        KIS_ASSERT_RECOVER_NOOP(indicator);
+        if (indicator) {
+            indicator->update();
+        }
+
+        bool isShared = false;
+        KoColorTransformation *transformation =
+            filter->fetchTransformation(cs, filterMask->filter(), &isShared);
+
+        if (!transformation) continue;
+
+        transformations << transformation;
+        if (!isShared) {
+            ownedTransformations << transformation;
+        }
+    }
+
+    const int numTransformations = transformations.size();
+
+    KisSequentialIterator it(device, rect);
+
+    int conseq = it.nConseqPixels();
+    while (it.nextPixels(conseq)) {
+        conseq = it.nConseqPixels();
+
+        for (int i = 0; i < numTransformations; i++) {
+            transformations[i]->transform(it.rawData(), it.rawData(), conseq);
+        }
+    }
+
+    qDeleteAll(ownedTransformations);
+}
+
+}
+
 QRect KisLayer::applyMasks(const KisPaintDeviceSP source,
                            KisPaintDeviceSP destination,
                            const QRect &requestedRect,
@@ -747,13 +810,40 @@ QRect KisLayer::applyMasks(const KisPaintDeviceSP source,
                 copyOriginalToProjection(source, destination, needRect);
             }
 
-            Q_FOREACH (const KisEffectMaskSP& mask, masks) {
+            int i = 0;
+            while (i < masks.size()) {
+                /**
+                 * Consecutive masks that are plain per-pixel color
+                 * adjustments are applied in a single pass over the
+                 * destination, instead of reading and writing it once
+                 * per mask.
+                 */
+                int numFused = 0;
+                while (i + numFused < masks.size() &&
+                       fusableColorFilter(masks[i + numFused], destination, applyRects.top())) {
+
+                    numFused++;
+                }
+
+                if (numFused > 1) {
+                    const QRect maskApplyRect = applyRects.top();
+                    for (int j = 0; j < numFused; j++) {
+                        applyRects.pop();
+                    }
+
+                    applyFusedColorMasks(masks.mid(i, numFused), destination, maskApplyRect);
+                    i += numFused;
+                    continue;
+                }
+
+                const KisEffectMaskSP &mask = masks[i];
                 const QRect maskApplyRect = applyRects.pop();
                 const QRect maskNeedRect =
                     applyRects.isEmpty() ? needRect : applyRects.top();
 
                 PositionToFilthy maskPosition = calculatePositionToFilthy(mask, filthyNode, const_cast<KisLayer*>(this));
                 mask->apply(destination, maskApplyRect, maskNeedRect, maskPosition);
+                i++;
             }
             Q_ASSERT(applyRects.isEmpty());
         } else {
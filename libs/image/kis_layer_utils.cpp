@@ -21,6 +21,7 @@
 #include <algorithm>
 
 #include <QUuid>
+#include <QtConcurrent>
 #include <KoColorSpaceConstants.h>
 #include <KoProperties.h>
 
@@ -510,12 +511,45 @@ namespace KisLayerUtils {
         MergeLayersMultiple(MergeMultipleInfoSP info) : m_info(info) {}
 
         void populateChildCommands() override {
-            KisPainter gc(m_info->dstNode->paintDevice());
+            KisPaintDeviceSP dstDevice = m_info->dstNode->paintDevice();
+
+            struct SourcePlane {
+                KisAbstractProjectionPlaneSP plane;
+                QRect rect;
+            };
+
+            QVector<SourcePlane> sources;
+            QRect totalRect;
 
             foreach (KisNodeSP node, m_info->allSrcNodes()) {
-                QRect rc = node->exactBounds() | m_info->image->bounds();
-                node->projectionPlane()->apply(&gc, rc);
+                const QRect rc = node->exactBounds() | m_info->image->bounds();
+                sources.append({node->projectionPlane(), rc});
+                totalRect |= rc;
             }
+
+            /**
+             * The nodes are composed patch-by-patch, each patch in its
+             * own thread. The patches do not overlap, so no pixel of the
+             * destination is written twice. The patch size comes from the
+             * update config and is not necessarily a multiple of the tile
+             * size, so the tiles on the patch borders may be shared
+             * between the threads; the tiled data manager serializes
+             * access to them.
+             */
+            QVector<QRect> patches =
+                KritaUtils::splitRectIntoPatches(totalRect, KritaUtils::optimalPatchSize());
+
+            QtConcurrent::blockingMap(patches,
+                [dstDevice, &sources] (QRect &patch) {
+                    KisPainter gc(dstDevice);
+
+                    Q_FOREACH (const SourcePlane &source, sources) {
+                        const QRect rc = source.rect & patch;
+                        if (!rc.isEmpty()) {
+                            source.plane->apply(&gc, rc);
+                        }
+                    }
+                });
         }
 
     private:
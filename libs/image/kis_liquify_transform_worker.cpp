@@ -22,6 +22,15 @@
 #include "kis_dom_utils.h"
 #include "krita_utils.h"
 
+#include <QThread>
+#include <QtConcurrentMap>
+
+#include <KoCompositeOpRegistry.h>
+
+#include "kis_painter.h"
+#include "kis_selection.h"
+#include "kis_pixel_selection.h"
+
 
 struct Q_DECL_HIDDEN KisLiquifyTransformWorker::Private
 {
@@ -430,6 +439,15 @@ struct KisLiquifyTransformWorker::Private::MapIndexesOp {
 };
 
 
+namespace {
+struct GridBand {
+    int firstRow;
+    int lastRow;
+    KisPaintDeviceSP dstDev;
+    KisSelectionSP writtenMask;
+};
+}
+
 void KisLiquifyTransformWorker::run(KisPaintDeviceSP device)
 {
     KisPaintDeviceSP srcDev = new KisPaintDevice(*device.data());
@@ -437,12 +455,59 @@ void KisLiquifyTransformWorker::run(KisPaintDeviceSP device)
 
     using namespace GridIterationTools;
 
-    PaintDevicePolygonOp polygonOp(srcDev, device);
-    Private::MapIndexesOp indexesOp(m_d.data());
-    iterateThroughGrid<AlwaysCompletePolygonPolicy>(polygonOp, indexesOp,
-                                                    m_d->gridSize,
-                                                    m_d->originalPoints,
-                                                    m_d->transformedPoints);
+    const int minRowsPerBand = 16;
+    const int numCellRows = m_d->gridSize.height() - 1;
+    const int numBands = qMin(QThread::idealThreadCount(), numCellRows / minRowsPerBand);
+
+    if (numBands <= 1) {
+        PaintDevicePolygonOp polygonOp(srcDev, device);
+        Private::MapIndexesOp indexesOp(m_d.data());
+        iterateThroughGrid<AlwaysCompletePolygonPolicy>(polygonOp, indexesOp,
+                                                        m_d->gridSize,
+                                                        m_d->originalPoints,
+                                                        m_d->transformedPoints);
+        return;
+    }
+
+    /**
+     * The deformed cells may overlap, so the cell rows are split into bands,
+     * and every band is rendered into a separate device. Then the bands are
+     * copied into the destination in the order of the rows, but only the
+     * pixels that were actually written. The result is exactly the same as
+     * if all the cells were processed sequentially.
+     */
+    QVector<GridBand> bands;
+    for (int i = 0; i < numBands; i++) {
+        GridBand band;
+        band.firstRow = i * numCellRows / numBands;
+        band.lastRow = (i + 1) * numCellRows / numBands - 1;
+        band.dstDev = new KisPaintDevice(device->colorSpace());
+        band.writtenMask = new KisSelection();
+        bands << band;
+    }
+
+    auto processBand = [&] (GridBand &band) {
+        PaintDevicePolygonOp polygonOp(srcDev, band.dstDev, band.writtenMask->pixelSelection());
+        Private::MapIndexesOp indexesOp(m_d.data());
+        iterateThroughGrid<AlwaysCompletePolygonPolicy>(polygonOp, indexesOp,
+                                                        m_d->gridSize,
+                                                        m_d->originalPoints,
+                                                        m_d->transformedPoints,
+                                                        band.firstRow, band.lastRow);
+    };
+
+    QtConcurrent::blockingMap(bands, processBand);
+
+    KisPainter gc(device);
+    gc.setCompositeOp(COMPOSITE_COPY);
+
+    Q_FOREACH (const GridBand &band, bands) {
+        const QRect rc = band.writtenMask->pixelSelection()->extent();
+        if (rc.isEmpty()) continue;
+
+        gc.setSelection(band.writtenMask);
+        gc.bitBlt(rc.topLeft(), band.dstDev, rc);
+    }
 }
 
 QRect KisLiquifyTransformWorker::approxChangeRect(const QRect &rc)
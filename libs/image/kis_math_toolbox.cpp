@@ -28,6 +28,9 @@
 
 #include <QVector>
 #include <QGlobalStatic>
+#include <QPair>
+#include <QThread>
+#include <QtConcurrent>
 
 #include <KoColorSpaceMaths.h>
 
@@ -216,35 +219,83 @@ double KisMathToolbox::maxChannelValue(KoChannelInfo *c)
     }
 }
 
+namespace {
+
+/**
+ * Every row of a level of the wavelet is calculated from its own pair
+ * of the source rows, so the rows can be split into stripes and
+ * processed concurrently. Every coefficient is calculated in exactly
+ * the same way, so the result doesn't depend on the split.
+ */
+template <class Func>
+void processRowsConcurrently(uint numRows, Func func)
+{
+    const uint minStripeHeight = 32;
+    const uint numThreads = qMax(1, QThread::idealThreadCount());
+    const uint stripeHeight = qMax(minStripeHeight, numRows / (4 * numThreads) + 1);
+
+    if (numThreads == 1 || numRows <= stripeHeight) {
+        func(qMakePair(0U, numRows));
+        return;
+    }
+
+    QVector<QPair<uint, uint>> stripes;
+    for (uint start = 0; start < numRows; start += stripeHeight) {
+        stripes << qMakePair(start, qMin(start + stripeHeight, numRows));
+    }
+
+    QtConcurrent::blockingMap(stripes, func);
+}
+
+/**
+ * Copies the four quadrants of the level of size \p halfsize from
+ * \p buff into \p wav. It can be done only when the whole level is
+ * calculated, because the rows of \p wav may still be read by the
+ * other stripes.
+ */
+void copyQuadrants(KisMathToolbox::KisWavelet* wav, KisMathToolbox::KisWavelet* buff, uint halfsize)
+{
+    const uint l = (2 * halfsize) * wav->depth * sizeof(float);
+
+    processRowsConcurrently(halfsize, [wav, buff, halfsize, l] (const QPair<uint, uint> &stripe) {
+        for (uint i = stripe.first; i < stripe.second; i++) {
+            uint p = i * wav->size * wav->depth;
+            memcpy(wav->coeffs + p, buff->coeffs + p, l);
+            p = (i + halfsize) * wav->size * wav->depth;
+            memcpy(wav->coeffs + p, buff->coeffs + p, l);
+        }
+    });
+}
+
+}
+
 void KisMathToolbox::wavetrans(KisMathToolbox::KisWavelet* wav, KisMathToolbox::KisWavelet* buff, uint halfsize)
 {
-    uint l = (2 * halfsize) * wav->depth * sizeof(float);
-    for (uint i = 0; i < halfsize; i++) {
-        float * itLL = buff->coeffs + i * buff->size * buff->depth;
-        float * itHL = buff->coeffs + (i * buff->size + halfsize) * buff->depth;
-        float * itLH = buff->coeffs + (halfsize + i) * buff->size * buff->depth;
-        float * itHH = buff->coeffs + ((halfsize + i) * buff->size + halfsize) * buff->depth;
-        float * itS11 = wav->coeffs + 2 * i * wav->size * wav->depth;
-        float * itS12 = wav->coeffs + (2 * i * wav->size + 1) * wav->depth;
-        float * itS21 = wav->coeffs + (2 * i + 1) * wav->size * wav->depth;
-        float * itS22 = wav->coeffs + ((2 * i + 1) * wav->size + 1) * wav->depth;
-        for (uint j = 0; j < halfsize; j++) {
-            for (uint k = 0; k < wav->depth; k++) {
-                *(itLL++) = (*itS11 + *itS12 + *itS21 + *itS22) * M_SQRT1_2;
-                *(itHL++) = (*itS11 - *itS12 + *itS21 - *itS22) * M_SQRT1_2;
-                *(itLH++) = (*itS11 + *itS12 - *itS21 - *itS22) * M_SQRT1_2;
-                *(itHH++) = (*(itS11++) - *(itS12++) - *(itS21++) + *(itS22++)) * M_SQRT1_2;
+    processRowsConcurrently(halfsize, [wav, buff, halfsize] (const QPair<uint, uint> &stripe) {
+        for (uint i = stripe.first; i < stripe.second; i++) {
+            float * itLL = buff->coeffs + i * buff->size * buff->depth;
+            float * itHL = buff->coeffs + (i * buff->size + halfsize) * buff->depth;
+            float * itLH = buff->coeffs + (halfsize + i) * buff->size * buff->depth;
+            float * itHH = buff->coeffs + ((halfsize + i) * buff->size + halfsize) * buff->depth;
+            float * itS11 = wav->coeffs + 2 * i * wav->size * wav->depth;
+            float * itS12 = wav->coeffs + (2 * i * wav->size + 1) * wav->depth;
+            float * itS21 = wav->coeffs + (2 * i + 1) * wav->size * wav->depth;
+            float * itS22 = wav->coeffs + ((2 * i + 1) * wav->size + 1) * wav->depth;
+            for (uint j = 0; j < halfsize; j++) {
+                for (uint k = 0; k < wav->depth; k++) {
+                    *(itLL++) = (*itS11 + *itS12 + *itS21 + *itS22) * M_SQRT1_2;
+                    *(itHL++) = (*itS11 - *itS12 + *itS21 - *itS22) * M_SQRT1_2;
+                    *(itLH++) = (*itS11 + *itS12 - *itS21 - *itS22) * M_SQRT1_2;
+                    *(itHH++) = (*(itS11++) - *(itS12++) - *(itS21++) + *(itS22++)) * M_SQRT1_2;
+                }
+                itS11 += wav->depth; itS12 += wav->depth;
+                itS21 += wav->depth; itS22 += wav->depth;
             }
-            itS11 += wav->depth; itS12 += wav->depth;
-            itS21 += wav->depth; itS22 += wav->depth;
         }
-    }
-    for (uint i = 0; i < halfsize; i++) {
-        uint p = i * wav->size * wav->depth;
-        memcpy(wav->coeffs + p, buff->coeffs + p, l);
-        p = (i + halfsize) * wav->size * wav->depth;
-        memcpy(wav->coeffs + p, buff->coeffs + p, l);
-    }
+    });
+
+    copyQuadrants(wav, buff, halfsize);
+
     if (halfsize != 1) {
         wavetrans(wav, buff, halfsize / 2);
     }
@@ -252,33 +303,30 @@ void KisMathToolbox::wavetrans(KisMathToolbox::KisWavelet* wav, KisMathToolbox::
 
 void KisMathToolbox::waveuntrans(KisMathToolbox::KisWavelet* wav, KisMathToolbox::KisWavelet* buff, uint halfsize)
 {
-    uint l = (2 * halfsize) * wav->depth * sizeof(float);
-    for (uint i = 0; i < halfsize; i++) {
-        float * itLL = wav->coeffs + i * buff->size * buff->depth;
-        float * itHL = wav->coeffs + (i * buff->size + halfsize) * buff->depth;
-        float * itLH = wav->coeffs + (halfsize + i) * buff->size * buff->depth;
-        float * itHH = wav->coeffs + ((halfsize + i) * buff->size + halfsize) * buff->depth;
-        float * itS11 = buff->coeffs + 2 * i * wav->size * wav->depth;
-        float * itS12 = buff->coeffs + (2 * i * wav->size + 1) * wav->depth;
-        float * itS21 = buff->coeffs + (2 * i + 1) * wav->size * wav->depth;
-        float * itS22 = buff->coeffs + ((2 * i + 1) * wav->size + 1) * wav->depth;
-        for (uint j = 0; j < halfsize; j++) {
-            for (uint k = 0; k < wav->depth; k++) {
-                *(itS11++) = (*itLL + *itHL + *itLH + *itHH) * 0.25 * M_SQRT2;
-                *(itS12++) = (*itLL - *itHL + *itLH - *itHH) * 0.25 * M_SQRT2;
-                *(itS21++) = (*itLL + *itHL - *itLH - *itHH) * 0.25 * M_SQRT2;
-                *(itS22++) = (*(itLL++) - *(itHL++) - *(itLH++) + *(itHH++)) * 0.25 * M_SQRT2;
+    processRowsConcurrently(halfsize, [wav, buff, halfsize] (const QPair<uint, uint> &stripe) {
+        for (uint i = stripe.first; i < stripe.second; i++) {
+            float * itLL = wav->coeffs + i * buff->size * buff->depth;
+            float * itHL = wav->coeffs + (i * buff->size + halfsize) * buff->depth;
+            float * itLH = wav->coeffs + (halfsize + i) * buff->size * buff->depth;
+            float * itHH = wav->coeffs + ((halfsize + i) * buff->size + halfsize) * buff->depth;
+            float * itS11 = buff->coeffs + 2 * i * wav->size * wav->depth;
+            float * itS12 = buff->coeffs + (2 * i * wav->size + 1) * wav->depth;
+            float * itS21 = buff->coeffs + (2 * i + 1) * wav->size * wav->depth;
+            float * itS22 = buff->coeffs + ((2 * i + 1) * wav->size + 1) * wav->depth;
+            for (uint j = 0; j < halfsize; j++) {
+                for (uint k = 0; k < wav->depth; k++) {
+                    *(itS11++) = (*itLL + *itHL + *itLH + *itHH) * 0.25 * M_SQRT2;
+                    *(itS12++) = (*itLL - *itHL + *itLH - *itHH) * 0.25 * M_SQRT2;
+                    *(itS21++) = (*itLL + *itHL - *itLH - *itHH) * 0.25 * M_SQRT2;
+                    *(itS22++) = (*(itLL++) - *(itHL++) - *(itLH++) + *(itHH++)) * 0.25 * M_SQRT2;
+                }
+                itS11 += wav->depth; itS12 += wav->depth;
+                itS21 += wav->depth; itS22 += wav->depth;
             }
-            itS11 += wav->depth; itS12 += wav->depth;
-            itS21 += wav->depth; itS22 += wav->depth;
         }
-    }
-    for (uint i = 0; i < halfsize; i++) {
-        uint p = i * wav->size * wav->depth;
-        memcpy(wav->coeffs + p, buff->coeffs + p, l);
-        p = (i + halfsize) * wav->size * wav->depth;
-        memcpy(wav->coeffs + p, buff->coeffs + p, l);
-    }
+    });
+
+    copyQuadrants(wav, buff, halfsize);
 
     if (halfsize != wav->size / 2) {
         waveuntrans(wav, buff, halfsize*2);
@@ -29,22 +29,45 @@
 #include <kis_iterator_ng.h>
 #include <kis_random_accessor_ng.h>
 
+/**
+ * The storage keeps the "filled" state of every pixel of the buffer in
+ * the high bit of the marks array. It is calculated in a single pass over
+ * the buffer, so the tracing code doesn't have to call the (virtual)
+ * KoColorSpace::opacityU8() several times for every pixel.
+ */
 class LinearStorage
 {
 public:
     typedef quint8* StorageType;
+    static const quint8 FilledFlag = 0x80;
+
 public:
-    LinearStorage(quint8 *buffer, int width, int height, int pixelSize)
-        : m_buffer(buffer),
-          m_width(width),
-          m_pixelSize(pixelSize)
+    LinearStorage(quint8 *buffer, int width, int height, const KoColorSpace *cs, quint8 defaultOpacity)
+        : m_width(width)
     {
-        m_marks.reset(new quint8[width * height]);
-        memset(m_marks.data(), 0, width * height);
+        const int numPixels = width * height;
+
+        m_marks.reset(new quint8[numPixels]);
+        quint8 *marks = m_marks.data();
+
+        if (cs == KoColorSpaceRegistry::instance()->alpha8()) {
+            // the loop is simple enough to be vectorized by the compiler
+            for (int i = 0; i < numPixels; i++) {
+                marks[i] = buffer[i] != defaultOpacity ? FilledFlag : 0;
+            }
+        } else {
+            const int pixelSize = cs->pixelSize();
+            const quint8 *pixel = buffer;
+
+            for (int i = 0; i < numPixels; i++) {
+                marks[i] = cs->opacityU8(pixel) != defaultOpacity ? FilledFlag : 0;
+                pixel += pixelSize;
+            }
+        }
     }
 
-    quint8* pickPixel(int x, int y) {
-        return m_buffer + (m_width * y + x) * m_pixelSize;
+    bool isFilled(int x, int y) {
+        return m_marks[m_width * y + x] & FilledFlag;
     }
 
     quint8* pickMark(int x, int y) {
@@ -53,9 +76,7 @@ public:
 
 private:
     QScopedArrayPointer<quint8> m_marks;
-    quint8 *m_buffer;
     int m_width;
-    int m_pixelSize;
 };
 
 class PaintDeviceStorage
@@ -63,8 +84,10 @@ class PaintDeviceStorage
 public:
     typedef const KisPaintDevice* StorageType;
 public:
-    PaintDeviceStorage(const KisPaintDevice *device, int /*width*/, int /*height*/, int /*pixelSize*/)
-        : m_device(device)
+    PaintDeviceStorage(const KisPaintDevice *device, int /*width*/, int /*height*/, const KoColorSpace *cs, quint8 defaultOpacity)
+        : m_device(device),
+          m_cs(cs),
+          m_defaultOpacity(defaultOpacity)
     {
         m_deviceIt = m_device->createRandomConstAccessorNG(0, 0);
 
@@ -73,9 +96,9 @@ public:
         m_marksIt = m_marks->createRandomAccessorNG(0, 0);
     }
 
-    const quint8* pickPixel(int x, int y) {
+    bool isFilled(int x, int y) {
         m_deviceIt->moveTo(x, y);
-        return m_deviceIt->rawDataConst();
+        return m_cs->opacityU8(m_deviceIt->rawDataConst()) != m_defaultOpacity;
     }
 
     quint8* pickMark(int x, int y) {
@@ -86,6 +109,8 @@ public:
 private:
     KisPaintDeviceSP m_marks;
     const KisPaintDevice *m_device;
+    const KoColorSpace *m_cs;
+    quint8 m_defaultOpacity;
     KisRandomConstAccessorSP m_deviceIt;
     KisRandomAccessorSP m_marksIt;
 };
@@ -106,12 +131,12 @@ QVector<QPolygon> KisOutlineGenerator::outlineImpl(typename StorageStrategy::Sto
     QVector<QPolygon> paths;
 
     try {
-        StorageStrategy storage(buffer, width, height, m_cs->pixelSize());
+        StorageStrategy storage(buffer, width, height, m_cs, m_defaultOpacity);
 
         for (qint32 y = 0; y < height; y++) {
             for (qint32 x = 0; x < width; x++) {
 
-                if (m_cs->opacityU8(storage.pickPixel(x, y)) == m_defaultOpacity)
+                if (!storage.isFilled(x, y))
                     continue;
 
                 EdgeType startEdge = TopEdge;
@@ -179,18 +204,18 @@ QVector<QPolygon> KisOutlineGenerator::outline(const KisPaintDevice *buffer, qin
 template <class StorageStrategy>
 bool KisOutlineGenerator::isOutlineEdge(StorageStrategy &storage, EdgeType edge, qint32 x, qint32 y, qint32 bufWidth, qint32 bufHeight)
 {
-    if (m_cs->opacityU8(storage.pickPixel(x, y)) == m_defaultOpacity)
+    if (!storage.isFilled(x, y))
         return false;
 
     switch (edge) {
     case LeftEdge:
-        return x == 0 || m_cs->opacityU8(storage.pickPixel(x - 1, y)) == m_defaultOpacity;
+        return x == 0 || !storage.isFilled(x - 1, y);
     case TopEdge:
-        return y == 0 || m_cs->opacityU8(storage.pickPixel(x, y - 1)) == m_defaultOpacity;
+        return y == 0 || !storage.isFilled(x, y - 1);
     case RightEdge:
-        return x == bufWidth - 1 || m_cs->opacityU8(storage.pickPixel(x + 1, y)) == m_defaultOpacity;
+        return x == bufWidth - 1 || !storage.isFilled(x + 1, y);
     case BottomEdge:
-        return y == bufHeight - 1 || m_cs->opacityU8(storage.pickPixel(x, y + 1)) == m_defaultOpacity;
+        return y == bufHeight - 1 || !storage.isFilled(x, y + 1);
     case NoEdge:
         return false;
     }
@@ -1373,6 +1373,43 @@ QRect calculateExactBoundsImpl(const KisPaintDevice *device, const QRect &startR
                  boundBottom - boundTop + 1);
 }
 
+/**
+ * Calculates the exact bounds patch-by-patch, only over the allocated
+ * tiles of the device. All the other pixels are default, so they are
+ * known to be empty. A patch that is fully contained in the bounds
+ * found so far cannot extend them, so it is skipped without reading
+ * any pixels, and for the rest of the patches only the part sticking
+ * out of the current bounds is scanned. It makes calculating bounds
+ * of huge sparse devices much cheaper than scanning inwards from the
+ * edges of the extent.
+ *
+ * \p endRect has the same meaning as in calculateExactBoundsImpl():
+ * the area that is always included into the result.
+ */
+template <class ComparePixelOp>
+QRect calculateExactBoundsTiled(const KisPaintDevice *device, const QRect &startRect, const QRect &endRect, ComparePixelOp compareOp)
+{
+    if (startRect == endRect) return startRect;
+    if (!startRect.isValid()) return QRect();
+
+    QRect resultRect = endRect;
+
+    const int patchSize = 64;
+    QVector<QRect> rects = device->region().rects();
+
+    Q_FOREACH (const QRect &rc1, rects) {
+        QVector<QRect> patches = KritaUtils::splitRectIntoPatches(rc1 & startRect, QSize(patchSize, patchSize));
+
+        Q_FOREACH (const QRect &rc2, patches) {
+            if (resultRect.contains(rc2)) continue;
+
+            resultRect |= calculateExactBoundsImpl(device, rc2, resultRect & rc2, compareOp);
+        }
+    }
+
+    return resultRect;
+}
+
 }
 
 QRect KisPaintDevice::calculateExactBounds(bool nonDefaultOnly) const
@@ -1399,10 +1436,10 @@ QRect KisPaintDevice::calculateExactBounds(bool nonDefaultOnly) const
     if (nonDefaultOnly) {
         const KoColor defaultPixel = this->defaultPixel();
         Impl::CheckNonDefault compareOp(pixelSize(), defaultPixel.data());
-        endRect = Impl::calculateExactBoundsImpl(this, startRect, endRect, compareOp);
+        endRect = Impl::calculateExactBoundsTiled(this, startRect, endRect, compareOp);
     } else {
         Impl::CheckFullyTransparent compareOp(m_d->colorSpace());
-        endRect = Impl::calculateExactBoundsImpl(this, startRect, endRect, compareOp);
+        endRect = Impl::calculateExactBoundsTiled(this, startRect, endRect, compareOp);
     }
 
     return endRect;
@@ -230,14 +230,24 @@ void KisPainter::copyAreaOptimized(const QPoint &dstPt,
 
 KisPaintDeviceSP KisPainter::convertToAlphaAsAlpha(KisPaintDeviceSP src)
 {
-    const KoColorSpace *srcCS = src->colorSpace();
     const QRect processRect = src->extent();
     KisPaintDeviceSP dst(new KisPaintDevice(KoColorSpaceRegistry::instance()->alpha8()));
 
     if (processRect.isEmpty()) return dst;
 
-    KisSequentialConstIterator srcIt(src, processRect);
-    KisSequentialIterator dstIt(dst, processRect);
+    convertToAlphaAsAlpha(src, dst, processRect);
+
+    return dst;
+}
+
+void KisPainter::convertToAlphaAsAlpha(KisPaintDeviceSP src, KisPaintDeviceSP dst, const QRect &rect)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(*dst->colorSpace() == *KoColorSpaceRegistry::instance()->alpha8());
+
+    const KoColorSpace *srcCS = src->colorSpace();
+
+    KisSequentialConstIterator srcIt(src, rect);
+    KisSequentialIterator dstIt(dst, rect);
 
     while (srcIt.nextPixel() && dstIt.nextPixel()) {
         const quint8 *srcPtr = srcIt.rawDataConst();
@@ -248,8 +258,6 @@ KisPaintDeviceSP KisPainter::convertToAlphaAsAlpha(KisPaintDeviceSP src)
 
         *alpha8Ptr = KoColorSpaceMaths<quint8>::multiply(alpha, KoColorSpaceMathsTraits<quint8>::unitValue - white);
     }
-
-    return dst;
 }
 
 KisPaintDeviceSP KisPainter::convertToAlphaAsGray(KisPaintDeviceSP src)
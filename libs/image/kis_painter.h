@@ -106,6 +106,13 @@ public:
                                   KisSelectionSP selection);
 
     static KisPaintDeviceSP convertToAlphaAsAlpha(KisPaintDeviceSP src);
+
+    /**
+     * Converts \p rect of \p src into the alpha8 device \p dst, the
+     * same way as convertToAlphaAsAlpha(src) does. It can be used for
+     * converting a big device patch-by-patch in several threads.
+     */
+    static void convertToAlphaAsAlpha(KisPaintDeviceSP src, KisPaintDeviceSP dst, const QRect &rect);
     static KisPaintDeviceSP convertToAlphaAsGray(KisPaintDeviceSP src);
     static bool checkDeviceHasTransparency(KisPaintDeviceSP dev);
 
@@ -19,17 +19,309 @@
 
 #include "kis_selection_filters.h"
 
+#include <limits>
+
 #include <klocalizedstring.h>
 
+#include <QtConcurrentMap>
+
 #include <KoColorSpace.h>
 #include "kis_convolution_painter.h"
 #include "kis_convolution_kernel.h"
 #include "kis_pixel_selection.h"
+#include "kis_iterator_ng.h"
 
 #define MAX(a, b) ((a) > (b) ? (a) : (b))
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
 #define RINT(x) floor ((x) + 0.5)
 
+namespace {
+
+/**
+ * Binary selections (that is, the ones having only fully selected and
+ * fully deselected pixels) are grown and shrunk using a two-pass
+ * distance transform. The first pass finds the vertical distance to the
+ * nearest feature pixel of every column. The second one, instead of
+ * thresholding the euclidean distance, lets every pixel cover the row
+ * span in which the structuring element (see computeBorder()) is at
+ * least as high as that distance. The result is exactly the same as the
+ * one of the generic algorithm, and both passes take constant time per
+ * pixel, whatever the radius is.
+ *
+ * The selection is processed in horizontal bands that are independent
+ * from each other, so they are processed concurrently. Every band reads
+ * the source with a vertical margin equal to the radius of the filter,
+ * the pixels further than that cannot affect the result anyway.
+ */
+
+const quint16 infiniteVerticalDistance = std::numeric_limits<quint16>::max();
+
+bool isBinarySelection(KisPaintDeviceSP device, const QRect &rect)
+{
+    KisSequentialConstIterator it(device, rect);
+
+    int numConseqPixels = it.nConseqPixels();
+    while (it.nextPixels(numConseqPixels)) {
+        numConseqPixels = it.nConseqPixels();
+
+        const quint8 *pixel = it.rawDataConst();
+        for (int i = 0; i < numConseqPixels; i++) {
+            if (pixel[i] != MIN_SELECTED && pixel[i] != MAX_SELECTED) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+int bandHeightForRadius(int yRadius)
+{
+    return qMax(64, 2 * yRadius);
+}
+
+/**
+ * Returns the rows of \p rect that should be read for calculating the
+ * distances in \p band
+ */
+QRect sourceRectForBand(const QRect &band, const QRect &rect, int yRadius)
+{
+    return QRect(rect.x(), band.y() - yRadius,
+                 rect.width(), band.height() + 2 * yRadius) & rect;
+}
+
+template <class Func>
+void processBandsConcurrently(const QRect &rect, int bandHeight, Func func)
+{
+    QVector<QRect> bands;
+
+    for (int y = rect.top(); y <= rect.bottom(); y += bandHeight) {
+        bands << QRect(rect.x(), y, rect.width(), qMin(bandHeight, rect.bottom() + 1 - y));
+    }
+
+    QtConcurrent::blockingMap(bands, func);
+}
+
+/**
+ * For every pixel of the rows [bandStart, bandStart + bandHeight) of
+ * the \p features map finds the vertical distance to the closest feature
+ * pixel in the same column. The distances larger than \p maxDistance
+ * are considered infinite.
+ */
+void calculateVerticalDistances(const quint8 *features, int width, int numRows,
+                                int bandStart, int bandHeight, int maxDistance,
+                                quint16 *result)
+{
+    const int noFeature = std::numeric_limits<int>::max() / 4;
+    const int bandEnd = bandStart + bandHeight;
+
+    QVector<int> nearest(width, -noFeature);
+
+    for (int y = 0; y < bandEnd; y++) {
+        const quint8 *featuresRow = features + y * width;
+        for (int x = 0; x < width; x++) {
+            if (featuresRow[x]) {
+                nearest[x] = y;
+            }
+        }
+
+        if (y < bandStart) continue;
+
+        quint16 *resultRow = result + (y - bandStart) * width;
+        for (int x = 0; x < width; x++) {
+            const int distance = y - nearest[x];
+            resultRow[x] = distance <= maxDistance ? distance : infiniteVerticalDistance;
+        }
+    }
+
+    nearest.fill(noFeature);
+
+    for (int y = numRows - 1; y >= bandStart; y--) {
+        const quint8 *featuresRow = features + y * width;
+        for (int x = 0; x < width; x++) {
+            if (featuresRow[x]) {
+                nearest[x] = y;
+            }
+        }
+
+        if (y >= bandEnd) continue;
+
+        quint16 *resultRow = result + (y - bandStart) * width;
+        for (int x = 0; x < width; x++) {
+            const int distance = nearest[x] - y;
+            if (distance <= maxDistance) {
+                resultRow[x] = qMin(resultRow[x], quint16(distance));
+            }
+        }
+    }
+}
+
+/**
+ * For every vertical distance in range [0, yRadius] finds the largest
+ * horizontal offset at which the structuring element described by \p circ
+ * still reaches that distance, or -1 if it doesn't reach it at all. The
+ * element is convex, so it also reaches the distance at all the smaller
+ * offsets.
+ */
+QVector<int> calculateHalfWidths(const qint32 *circ, int xRadius, int yRadius)
+{
+    QVector<qint32> minReach(xRadius + 1);
+    minReach[0] = circ[0];
+
+    for (int dx = 1; dx <= xRadius; dx++) {
+        minReach[dx] = qMin(minReach[dx - 1], qMin(circ[dx], circ[-dx]));
+    }
+
+    QVector<int> halfWidths(yRadius + 1);
+    int halfWidth = xRadius;
+
+    for (int distance = 0; distance <= yRadius; distance++) {
+        while (halfWidth >= 0 && minReach[halfWidth] < distance) {
+            halfWidth--;
+        }
+        halfWidths[distance] = halfWidth;
+    }
+
+    return halfWidths;
+}
+
+/**
+ * Finds the pixels of \p band that have a pixel of the \p features map
+ * (that covers \p srcRect) inside their structuring element and passes
+ * every row of the result to \p rowOp. \p halfWidths is the result of
+ * calculateHalfWidths() for the element.
+ *
+ * Every column of a row covers the span of pixels around it given by the
+ * half-width for its vertical distance. The spans are accumulated as
+ * a difference array, so a row takes time linear in its width.
+ */
+template <class RowOp>
+void processReachedRows(const quint8 *features, const QRect &srcRect,
+                        const QRect &band, const QVector<int> &halfWidths,
+                        RowOp rowOp)
+{
+    const int width = srcRect.width();
+    const int offset = band.x() - srcRect.x();
+    const int yRadius = halfWidths.size() - 1;
+
+    QVector<quint16> dy(width * band.height());
+    calculateVerticalDistances(features, width, srcRect.height(),
+                               band.y() - srcRect.y(), band.height(), yRadius,
+                               dy.data());
+
+    QVector<int> coverage(band.width() + 1);
+    QVector<quint8> reached(band.width());
+
+    for (int row = 0; row < band.height(); row++) {
+        const quint16 *dyRow = dy.constData() + row * width;
+        coverage.fill(0);
+
+        for (int column = 0; column < width; column++) {
+            if (dyRow[column] == infiniteVerticalDistance) continue;
+
+            const int halfWidth = halfWidths[dyRow[column]];
+            const int start = qMax(0, column - offset - halfWidth);
+            const int end = qMin(band.width() - 1, column - offset + halfWidth);
+
+            if (start <= end) {
+                coverage[start]++;
+                coverage[end + 1]--;
+            }
+        }
+
+        int numCovering = 0;
+        for (int x = 0; x < band.width(); x++) {
+            numCovering += coverage[x];
+            reached[x] = numCovering > 0;
+        }
+
+        rowOp(band.y() + row, reached.constData());
+    }
+}
+
+void growBinarySelection(KisPixelSelectionSP pixelSelection, const QRect &rect,
+                         const qint32 *circ, qint32 xRadius, qint32 yRadius)
+{
+    KisPaintDeviceSP src = new KisPaintDevice(*pixelSelection);
+    const QVector<int> halfWidths = calculateHalfWidths(circ, xRadius, yRadius);
+
+    /**
+     * The generic algorithm considers the rows outside the rect to be
+     * deselected and the columns outside it equal to the edge ones. The
+     * latter cannot reach further than the edge columns themselves, so
+     * only the pixels inside the rect matter.
+     */
+
+    auto processBand = [&] (QRect &band) {
+        const QRect srcRect = sourceRectForBand(band, rect, yRadius);
+
+        QVector<quint8> features(srcRect.width() * srcRect.height());
+        src->readBytes(features.data(), srcRect);
+
+        for (int i = 0; i < features.size(); i++) {
+            features[i] = features[i] == MAX_SELECTED;
+        }
+
+        QVector<quint8> out(band.width());
+
+        processReachedRows(features.constData(), srcRect, band, halfWidths,
+            [&] (int y, const quint8 *reached) {
+                for (int x = 0; x < band.width(); x++) {
+                    out[x] = reached[x] ? MAX_SELECTED : MIN_SELECTED;
+                }
+                pixelSelection->writeBytes(out.constData(), band.x(), y, band.width(), 1);
+            });
+    };
+
+    processBandsConcurrently(rect, bandHeightForRadius(yRadius), processBand);
+}
+
+void shrinkBinarySelection(KisPixelSelectionSP pixelSelection, const QRect &rect,
+                           const qint32 *circ, qint32 xRadius, qint32 yRadius,
+                           bool edgeLock)
+{
+    KisPaintDeviceSP src = new KisPaintDevice(*pixelSelection);
+    const QVector<int> halfWidths = calculateHalfWidths(circ, xRadius, yRadius);
+
+    /**
+     * With the edge lock the pixels outside the rect are equal to the
+     * edge ones, so they cannot reach further than the edge itself.
+     * Without it they are considered to be deselected, and only the
+     * closest ring of them can affect something inside the rect.
+     */
+    const QRect extendedRect = edgeLock ? rect : rect.adjusted(-1, -1, 1, 1);
+
+    auto processBand = [&] (QRect &band) {
+        const QRect srcRect = sourceRectForBand(band, extendedRect, yRadius);
+
+        QVector<quint8> features(srcRect.width() * srcRect.height());
+        src->readBytes(features.data(), srcRect);
+
+        for (int y = 0; y < srcRect.height(); y++) {
+            quint8 *row = features.data() + y * srcRect.width();
+
+            for (int x = 0; x < srcRect.width(); x++) {
+                row[x] = row[x] == MIN_SELECTED ||
+                    !rect.contains(srcRect.x() + x, srcRect.y() + y);
+            }
+        }
+
+        QVector<quint8> out(band.width());
+
+        processReachedRows(features.constData(), srcRect, band, halfWidths,
+            [&] (int y, const quint8 *reached) {
+                for (int x = 0; x < band.width(); x++) {
+                    out[x] = reached[x] ? MIN_SELECTED : MAX_SELECTED;
+                }
+                pixelSelection->writeBytes(out.constData(), band.x(), y, band.width(), 1);
+            });
+    };
+
+    processBandsConcurrently(rect, bandHeightForRadius(yRadius), processBand);
+}
+
+}
+
 KisSelectionFilter::~KisSelectionFilter()
 {
 }
@@ -520,6 +812,14 @@ void KisGrowSelectionFilter::process(KisPixelSelectionSP pixelSelection, const Q
 {
     if (m_xRadius <= 0 || m_yRadius <= 0) return;
 
+    if (isBinarySelection(pixelSelection, rect)) {
+        QVector<qint32> circ(2 * m_xRadius + 1);
+        computeBorder(circ.data(), m_xRadius, m_yRadius);
+
+        growBinarySelection(pixelSelection, rect, circ.constData() + m_xRadius, m_xRadius, m_yRadius);
+        return;
+    }
+
     /**
         * Much code resembles Shrink filter, so please fix bugs
         * in both filters
@@ -542,7 +842,7 @@ void KisGrowSelectionFilter::process(KisPixelSelectionSP pixelSelection, const Q
         else
             max[i] = &buffer[(m_yRadius + 1) * (rect.width() + m_xRadius - 1)];
 
-        for (qint32 j = 0; j < m_xRadius + 1; j++)
+        for (qint32 j = 0; j < m_yRadius + 1; j++)
             max[i][j] = 0;
     }
     /* offset the max pointer by m_xRadius so the range of the array
@@ -647,6 +947,14 @@ void KisShrinkSelectionFilter::process(KisPixelSelectionSP pixelSelection, const
 {
     if (m_xRadius <= 0 || m_yRadius <= 0) return;
 
+    if (isBinarySelection(pixelSelection, rect)) {
+        QVector<qint32> circ(2 * m_xRadius + 1);
+        computeBorder(circ.data(), m_xRadius, m_yRadius);
+
+        shrinkBinarySelection(pixelSelection, rect, circ.constData() + m_xRadius, m_xRadius, m_yRadius, m_edgeLock);
+        return;
+    }
+
     /*
         pretty much the same as fatten_region only different
         blame all bugs in this function on jaycox@gimp.org
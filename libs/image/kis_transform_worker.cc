@@ -26,6 +26,9 @@
 #include <klocalizedstring.h>
 
 #include <QTransform>
+#include <QMutex>
+#include <QThread>
+#include <QtConcurrentMap>
 
 #include <KoColorSpace.h>
 #include <KoCompositeOpRegistry.h>
@@ -42,6 +45,7 @@
 #include "kis_progress_update_helper.h"
 #include "kis_pixel_selection.h"
 #include "kis_image.h"
+#include "kis_algebra_2d.h"
 
 
 KisTransformWorker::KisTransformWorker(KisPaintDeviceSP dev,
@@ -195,6 +199,49 @@ void updateBounds<KisVLineIteratorSP>(QRect &boundRect, const KisFilterWeightsAp
     boundRect.setHeight(newBounds.size());
 }
 
+template <class iter>
+int lineOffset(KisPaintDevice *dev);
+
+template <>
+int lineOffset<KisHLineIteratorSP>(KisPaintDevice *dev)
+{
+    return dev->y();
+}
+
+template <>
+int lineOffset<KisVLineIteratorSP>(KisPaintDevice *dev)
+{
+    return dev->x();
+}
+
+/**
+ * Splits the lines of the pass into stripes aligned to the tiles of the
+ * device, so that two stripes never share the same tile
+ */
+static QVector<KisFilterWeightsApplicator::LinePos> splitLinesIntoStripes(int firstLine, int numLines,
+                                                                          int offset, int numStripes)
+{
+    using namespace KisAlgebra2D;
+
+    const int tileSize = 64;
+
+    const int firstTile = divideFloor(firstLine - offset, tileSize);
+    const int lastTile = divideFloor(firstLine + numLines - 1 - offset, tileSize);
+    const int numTiles = lastTile - firstTile + 1;
+    const int tilesPerStripe = qMax(1, (numTiles + numStripes - 1) / numStripes);
+
+    QVector<KisFilterWeightsApplicator::LinePos> stripes;
+
+    for (int tile = firstTile; tile <= lastTile; tile += tilesPerStripe) {
+        const int start = qMax(firstLine, offset + tile * tileSize);
+        const int end = qMin(firstLine + numLines, offset + (tile + tilesPerStripe) * tileSize);
+
+        stripes << KisFilterWeightsApplicator::LinePos(start, end - start);
+    }
+
+    return stripes;
+}
+
 template <class T>
 void KisTransformWorker::transformPass(KisPaintDevice *src, KisPaintDevice *dst,
                                        double floatscale, double shear, double dx,
@@ -210,16 +257,51 @@ void KisTransformWorker::transformPass(KisPaintDevice *src, KisPaintDevice *dst,
     KisFilterWeightsBuffer buf(filterStrategy, qAbs(floatscale));
     KisFilterWeightsApplicator applicator(src, dst, floatscale, shear, dx, clampToEdge);
 
-    KisFilterWeightsApplicator::LinePos dstBounds;
+    /**
+     * The bounds of every line are stored separately and united in the
+     * order of the lines when the pass is finished. LinePos::unite()
+     * depends on the order of the arguments, so uniting them as the
+     * stripes complete would make the bounds of the next pass differ
+     * from run to run.
+     */
+    QVector<KisFilterWeightsApplicator::LinePos> lineBounds(qMax(0, numLines));
+    QMutex resultLock;
+
+    /**
+     * Every line is read and written by the applicator independently from
+     * the others (even when src == dst), so the lines can be processed
+     * concurrently. The result doesn't depend on the way the pass is
+     * split, so it stays exactly the same as in the single-threaded case.
+     */
+    auto processStripe = [&] (KisFilterWeightsApplicator::LinePos &stripe) {
+        for (int i = stripe.start(); i < stripe.end(); i++) {
+            KisFilterWeightsApplicator::LinePos srcPos(srcStart, srcLen);
 
-    for (int i = firstLine; i < firstLine + numLines; i++) {
-        KisFilterWeightsApplicator::LinePos dstPos;
-        KisFilterWeightsApplicator::LinePos srcPos(srcStart, srcLen);
+            lineBounds[i - firstLine] =
+                applicator.processLine<T>(srcPos, i, &buf, filterStrategy->support());
+        }
 
-        dstPos = applicator.processLine<T>(srcPos, i, &buf, filterStrategy->support());
-        dstBounds.unite(dstPos);
+        QMutexLocker l(&resultLock);
 
-        progressHelper.step();
+        for (int i = 0; i < stripe.size(); i++) {
+            progressHelper.step();
+        }
+    };
+
+    const int numThreads = QThread::idealThreadCount();
+    QVector<KisFilterWeightsApplicator::LinePos> stripes =
+        splitLinesIntoStripes(firstLine, numLines, lineOffset<T>(dst), 4 * numThreads);
+
+    if (numThreads > 1 && stripes.size() > 1) {
+        QtConcurrent::blockingMap(stripes, processStripe);
+    } else {
+        KisFilterWeightsApplicator::LinePos stripe(firstLine, numLines);
+        processStripe(stripe);
+    }
+
+    KisFilterWeightsApplicator::LinePos dstBounds;
+    Q_FOREACH (const KisFilterWeightsApplicator::LinePos &bounds, lineBounds) {
+        dstBounds.unite(bounds);
     }
 
     updateBounds<T>(m_boundRect, dstBounds);
@@ -97,15 +97,7 @@ int KisUpdaterContext::currentLevelOfDetail() const
 
 bool KisUpdaterContext::hasSpareThread()
 {
-    bool found = false;
-
-    Q_FOREACH (const KisUpdateJobItem *item, m_jobs) {
-        if(!item->isRunning()) {
-            found = true;
-            break;
-        }
-    }
-    return found;
+    return findSpareThread() >= 0;
 }
 
 bool KisUpdaterContext::isJobAllowed(KisBaseRectsWalkerSP walker)
@@ -136,7 +128,7 @@ bool KisUpdaterContext::isJobAllowed(KisBaseRectsWalkerSP walker)
 void KisUpdaterContext::addMergeJob(KisBaseRectsWalkerSP walker)
 {
     m_lodCounter.addLod(walker->levelOfDetail());
-    qint32 jobIndex = findSpareThread();
+    qint32 jobIndex = findWarmSpareThread();
     Q_ASSERT(jobIndex >= 0);
 
     const bool shouldStartThread = m_jobs[jobIndex]->setWalker(walker);
@@ -166,7 +158,7 @@ void KisUpdaterContext::addMergeJobTest(KisBaseRectsWalkerSP walker)
 void KisUpdaterContext::addStrokeJob(KisStrokeJob *strokeJob)
 {
     m_lodCounter.addLod(strokeJob->levelOfDetail());
-    qint32 jobIndex = findSpareThread();
+    qint32 jobIndex = findWarmSpareThread();
     Q_ASSERT(jobIndex >= 0);
 
     const bool shouldStartThread = m_jobs[jobIndex]->setStrokeJob(strokeJob);
@@ -196,7 +188,7 @@ void KisUpdaterContext::addStrokeJobTest(KisStrokeJob *strokeJob)
 void KisUpdaterContext::addSpontaneousJob(KisSpontaneousJob *spontaneousJob)
 {
     m_lodCounter.addLod(spontaneousJob->levelOfDetail());
-    qint32 jobIndex = findSpareThread();
+    qint32 jobIndex = findWarmSpareThread();
     Q_ASSERT(jobIndex >= 0);
 
     const bool shouldStartThread = m_jobs[jobIndex]->setSpontaneousJob(spontaneousJob);
@@ -244,6 +236,30 @@ qint32 KisUpdaterContext::findSpareThread()
     return -1;
 }
 
+/**
+ * A job item in WAITING state belongs to a thread that has just finished
+ * its job and is still spinning in KisUpdateJobItem::run(). Passing the
+ * new job to such an item lets that thread pick it up immediately, without
+ * going through QThreadPool::start() and waking up a sleeping thread. Only
+ * when there are no such "warm" items we fall back to an empty one.
+ */
+qint32 KisUpdaterContext::findWarmSpareThread()
+{
+    qint32 emptyJobIndex = -1;
+
+    for (qint32 i = 0; i < m_jobs.size(); i++) {
+        const KisUpdateJobItem::Type type = m_jobs[i]->type();
+
+        if (type == KisUpdateJobItem::Type::WAITING) {
+            return i;
+        } else if (type == KisUpdateJobItem::Type::EMPTY && emptyJobIndex < 0) {
+            emptyJobIndex = i;
+        }
+    }
+
+    return emptyJobIndex;
+}
+
 void KisUpdaterContext::lock()
 {
     m_lock.lock();
@@ -147,6 +147,7 @@ protected:
     static bool walkerIntersectsJob(KisBaseRectsWalkerSP walker,
                                     const KisUpdateJobItem* job);
     qint32 findSpareThread();
+    qint32 findWarmSpareThread();
 
 protected:
     /**
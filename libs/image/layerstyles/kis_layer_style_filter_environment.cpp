@@ -19,6 +19,9 @@
 #include "kis_layer_style_filter_environment.h"
 
 #include <QBitArray>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRegion>
 
 #include "kis_layer.h"
 #include "kis_ls_utils.h"
@@ -40,6 +43,17 @@ struct Q_DECL_HIDDEN KisLayerStyleFilterEnvironment::Private
     KisLayer *sourceLayer;
     KisPixelSelectionSP cachedRandomSelection;
 
+    /**
+     * The effect selection cache. The recalculation of the effect may
+     * happen in several threads at once, so all the access is guarded
+     * by the lock.
+     */
+    QMutex effectCacheLock;
+    QByteArray effectCacheKey;
+    KisPixelSelectionSP effectCacheAlpha;
+    KisPixelSelectionSP effectCacheResult;
+    QRegion effectCacheValidRegion;
+
     static KisPixelSelectionSP generateRandomSelection(const QRect &rc);
 };
 
@@ -131,3 +145,63 @@ KisPixelSelectionSP KisLayerStyleFilterEnvironment::cachedRandomSelection(const
 
     return m_d->cachedRandomSelection;
 }
+
+KisPixelSelectionSP KisLayerStyleFilterEnvironment::fetchCachedEffectSelection(const QByteArray &paramsKey,
+                                                                               KisPixelSelectionSP alpha,
+                                                                               const QRect &alphaRect,
+                                                                               const QRect &resultRect) const
+{
+    QMutexLocker l(&m_d->effectCacheLock);
+
+    if (!m_d->effectCacheResult ||
+        m_d->effectCacheKey != paramsKey ||
+        !(QRegion(resultRect) - m_d->effectCacheValidRegion).isEmpty()) {
+
+        return 0;
+    }
+
+    const int bufferSize = alphaRect.width() * alphaRect.height();
+    QByteArray currentAlpha(bufferSize, 0);
+    QByteArray cachedAlpha(bufferSize, 0);
+
+    alpha->readBytes(reinterpret_cast<quint8*>(currentAlpha.data()), alphaRect);
+    m_d->effectCacheAlpha->readBytes(reinterpret_cast<quint8*>(cachedAlpha.data()), alphaRect);
+
+    if (currentAlpha != cachedAlpha) return 0;
+
+    return new KisPixelSelection(*m_d->effectCacheResult);
+}
+
+void KisLayerStyleFilterEnvironment::storeCachedEffectSelection(const QByteArray &paramsKey,
+                                                                KisPixelSelectionSP alpha,
+                                                                const QRect &alphaRect,
+                                                                KisPixelSelectionSP result,
+                                                                const QRect &resultRect) const
+{
+    QMutexLocker l(&m_d->effectCacheLock);
+
+    if (!m_d->effectCacheResult || m_d->effectCacheKey != paramsKey) {
+        m_d->effectCacheKey = paramsKey;
+        m_d->effectCacheAlpha = new KisPixelSelection(*alpha);
+        m_d->effectCacheResult = new KisPixelSelection(*result);
+        m_d->effectCacheValidRegion = resultRect;
+        return;
+    }
+
+    /**
+     * Overwriting the alpha invalidates all the cached pixels that
+     * depend on it, that is, the ones lying closer to alphaRect than
+     * the effect's radius
+     */
+    const QRect dependentRect =
+        alphaRect.adjusted(alphaRect.left() - resultRect.left(),
+                           alphaRect.top() - resultRect.top(),
+                           alphaRect.right() - resultRect.right(),
+                           alphaRect.bottom() - resultRect.bottom());
+
+    m_d->effectCacheValidRegion -= dependentRect;
+    m_d->effectCacheValidRegion += resultRect;
+
+    KisPainter::copyAreaOptimized(alphaRect.topLeft(), alpha, m_d->effectCacheAlpha, alphaRect);
+    KisPainter::copyAreaOptimized(resultRect.topLeft(), result, m_d->effectCacheResult, resultRect);
+}
@@ -29,6 +29,7 @@ class KisPainter;
 class KisLayer;
 class QPainterPath;
 class QBitArray;
+class QByteArray;
 
 
 class KRITAIMAGE_EXPORT KisLayerStyleFilterEnvironment
@@ -47,6 +48,29 @@ public:
 
     KisPixelSelectionSP cachedRandomSelection(const QRect &requestedRect) const;
 
+    /**
+     * Returns a copy of the selection an effect has computed earlier
+     * from the alpha channel of the source layer, if it is still valid
+     * over \p resultRect, that is, it has been computed with the same
+     * \p paramsKey and the layer's \p alpha hasn't changed over
+     * \p alphaRect since then. Otherwise returns null.
+     */
+    KisPixelSelectionSP fetchCachedEffectSelection(const QByteArray &paramsKey,
+                                                   KisPixelSelectionSP alpha,
+                                                   const QRect &alphaRect,
+                                                   const QRect &resultRect) const;
+
+    /**
+     * Saves \p result computed over \p resultRect from the \p alpha
+     * channel of the layer over \p alphaRect, so that it could be
+     * reused by fetchCachedEffectSelection()
+     */
+    void storeCachedEffectSelection(const QByteArray &paramsKey,
+                                    KisPixelSelectionSP alpha,
+                                    const QRect &alphaRect,
+                                    KisPixelSelectionSP result,
+                                    const QRect &resultRect) const;
+
 private:
     struct Private;
     const QScopedPointer<Private> m_d;
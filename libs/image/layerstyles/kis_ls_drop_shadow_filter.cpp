@@ -21,6 +21,7 @@
 #include <cstdlib>
 
 #include <QBitArray>
+#include <QDataStream>
 
 #include <KoUpdater.h>
 #include <resources/KoAbstractGradient.h>
@@ -119,6 +120,35 @@ struct ShadowRectsData
     QRect spreadNeedRect;
 };
 
+/**
+ * The parameters of the shadow that affect the selection computed
+ * before applying the noise. Two shadows with the same key produce the
+ * same selection from the same alpha channel.
+ */
+QByteArray shadowSelectionCacheKey(const psd_layer_effects_shadow_base *shadow,
+                                   const ShadowRectsData &d,
+                                   bool isCenterGlow,
+                                   int levelOfDetail)
+{
+    QByteArray key;
+    QDataStream stream(&key, QIODevice::WriteOnly);
+
+    stream << levelOfDetail
+           << d.spread_size
+           << d.blur_size
+           << qint32(shadow->technique())
+           << shadow->range()
+           << shadow->invertsSelection()
+           << shadow->antiAliased()
+           << shadow->edgeHidden()
+           << isCenterGlow;
+
+    stream.writeRawData(reinterpret_cast<const char*>(shadow->contourLookupTable()),
+                        PSD_LOOKUP_TABLE_SIZE);
+
+    return key;
+}
+
 void applyDropShadow(KisPaintDeviceSP srcDevice,
                      KisMultipleProjection *dst,
                      const QRect &applyRect,
@@ -137,62 +167,84 @@ void applyDropShadow(KisPaintDeviceSP srcDevice,
 
     //selection->convertToQImage(0, QRect(0,0,300,300)).save("0_selection_initial.png");
 
-    if (shadow->invertsSelection()) {
-        selection->invert();
-    }
+    const psd_layer_effects_inner_glow *iglow =
+        dynamic_cast<const psd_layer_effects_inner_glow *>(shadow);
+    const bool isCenterGlow = iglow && iglow->source() == psd_glow_center;
 
     /**
-     * Copy selection which will be erased from the original later
+     * Spreading, blurring and contour correction depend on the alpha
+     * channel of the layer only, so when just the color of the layer
+     * changes, the selection computed on the previous update is reused
      */
-    KisPixelSelectionSP knockOutSelection;
-    if (shadow->knocksOut()) {
-        knockOutSelection = new KisPixelSelection(*selection);
-    }
+    const QByteArray cacheKey =
+        shadowSelectionCacheKey(shadow, d, isCenterGlow, env->currentLevelOfDetail());
 
-    if (shadow->technique() == psd_technique_precise) {
-        KisLsUtils::findEdge(selection, d.blurNeedRect, true);
-    }
+    KisPixelSelectionSP cachedSelection =
+        env->fetchCachedEffectSelection(cacheKey, selection, d.spreadNeedRect, d.noiseNeedRect);
 
-    /**
-     * Spread and blur the selection
-     */
-    if (d.spread_size) {
-        KisLsUtils::applyGaussianWithTransaction(selection, d.blurNeedRect, d.spread_size);
-
-        // TODO: find out why in libpsd we pass false here. If we do so,
-        //       the result is fully black, which is not expected
-        KisLsUtils::findEdge(selection, d.blurNeedRect, true /*shadow->edgeHidden()*/);
-    }
-
-    //selection->convertToQImage(0, QRect(0,0,300,300)).save("1_selection_spread.png");
-
-    if (d.blur_size) {
-        KisLsUtils::applyGaussianWithTransaction(selection, d.noiseNeedRect, d.blur_size);
+    KisPixelSelectionSP alphaSelection;
+    if (!cachedSelection) {
+        alphaSelection = new KisPixelSelection(*selection);
     }
-    //selection->convertToQImage(0, QRect(0,0,300,300)).save("2_selection_blur.png");
-
-    if (shadow->range() != KisLsUtils::FULL_PERCENT_RANGE) {
-        KisLsUtils::adjustRange(selection, d.noiseNeedRect, shadow->range());
-    }
-
-    const psd_layer_effects_inner_glow *iglow = 0;
-    if ((iglow =
-         dynamic_cast<const psd_layer_effects_inner_glow *>(shadow)) &&
-        iglow->source() == psd_glow_center) {
 
+    if (shadow->invertsSelection()) {
         selection->invert();
     }
 
     /**
-     * Contour correction
+     * Copy selection which will be erased from the original later
      */
-    KisLsUtils::applyContourCorrection(selection,
-                                       d.noiseNeedRect,
-                                       shadow->contourLookupTable(),
-                                       shadow->antiAliased(),
-                                       shadow->edgeHidden());
+    KisPixelSelectionSP knockOutSelection;
+    if (shadow->knocksOut()) {
+        knockOutSelection = new KisPixelSelection(*selection);
+    }
 
-    //selection->convertToQImage(0, QRect(0,0,300,300)).save("3_selection_contour.png");
+    if (cachedSelection) {
+        KisPainter::copyAreaOptimized(d.noiseNeedRect.topLeft(), cachedSelection, selection, d.noiseNeedRect);
+    } else {
+        if (shadow->technique() == psd_technique_precise) {
+            KisLsUtils::findEdge(selection, d.blurNeedRect, true);
+        }
+
+        /**
+         * Spread and blur the selection
+         */
+        if (d.spread_size) {
+            KisLsUtils::applyGaussianWithTransaction(selection, d.blurNeedRect, d.spread_size);
+
+            // TODO: find out why in libpsd we pass false here. If we do so,
+            //       the result is fully black, which is not expected
+            KisLsUtils::findEdge(selection, d.blurNeedRect, true /*shadow->edgeHidden()*/);
+        }
+
+        //selection->convertToQImage(0, QRect(0,0,300,300)).save("1_selection_spread.png");
+
+        if (d.blur_size) {
+            KisLsUtils::applyGaussianWithTransaction(selection, d.noiseNeedRect, d.blur_size);
+        }
+        //selection->convertToQImage(0, QRect(0,0,300,300)).save("2_selection_blur.png");
+
+        if (shadow->range() != KisLsUtils::FULL_PERCENT_RANGE) {
+            KisLsUtils::adjustRange(selection, d.noiseNeedRect, shadow->range());
+        }
+
+        if (isCenterGlow) {
+            selection->invert();
+        }
+
+        /**
+         * Contour correction
+         */
+        KisLsUtils::applyContourCorrection(selection,
+                                           d.noiseNeedRect,
+                                           shadow->contourLookupTable(),
+                                           shadow->antiAliased(),
+                                           shadow->edgeHidden());
+
+        //selection->convertToQImage(0, QRect(0,0,300,300)).save("3_selection_contour.png");
+
+        env->storeCachedEffectSelection(cacheKey, alphaSelection, d.spreadNeedRect, selection, d.noiseNeedRect);
+    }
 
     /**
      * Noise
@@ -20,6 +20,8 @@
 
 #include <QBitArray>
 
+#include <KoColorSpaceRegistry.h>
+
 #include "krita_utils.h"
 #include "kis_paint_device.h"
 #include "kis_lazy_fill_tools.h"
@@ -139,8 +141,7 @@ void KisColorizeStrokeStrategy::initStrokeCallback()
         splitRectIntoPatches(m_d->boundingRect, optimalPatchSize());
 
     if (!m_d->filteredSourceValid) {
-        // TODO: make this conversion concurrent!!!
-        KisPaintDeviceSP filteredMainDev = KisPainter::convertToAlphaAsAlpha(m_d->src);
+        KisPaintDeviceSP filteredMainDev = new KisPaintDevice(KoColorSpaceRegistry::instance()->alpha8());
         filteredMainDev->setDefaultBounds(m_d->src->defaultBounds());
 
         struct PrefilterSharedState {
@@ -156,6 +157,21 @@ void KisColorizeStrokeStrategy::initStrokeCallback()
         state->filteredMainDev = filteredMainDev;
         state->filteringOptions = m_d->filteringOptions;
 
+        /**
+         * The whole extent of the source is converted (not only the
+         * bounding rect), because the filters below read the pixels
+         * around the patches they process
+         */
+        KisPaintDeviceSP src = m_d->src;
+        const QVector<QRect> srcPatchRects =
+            splitRectIntoPatches(src->extent(), optimalPatchSize());
+
+        Q_FOREACH (const QRect &rc, srcPatchRects) {
+            addJobConcurrent(jobs, [state, src, rc] () {
+                KisPainter::convertToAlphaAsAlpha(src, state->filteredMainDev, rc);
+            });
+        }
+
         if (m_d->filteringOptions.useEdgeDetection &&
             m_d->filteringOptions.edgeDetectionSize > 0.0) {
 
@@ -122,4 +122,106 @@ void KisFilterMaskTest::testProjectionSelected()
 
 }
 
+void KisFilterMaskTest::testFusedColorMasks()
+{
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    QImage qimage(QString(FILES_DATA_DIR) + QDir::separator() + "hakonepa.png");
+    QImage inverted(QString(FILES_DATA_DIR) + QDir::separator() + "inverted_hakonepa.png");
+
+    KisFilterSP f = KisFilterRegistry::instance()->value("invert");
+    Q_ASSERT(f);
+
+    KisImageSP image = new KisImage(0, IMAGE_WIDTH, IMAGE_HEIGHT, cs, "tests");
+    KisPaintDeviceSP device = new KisPaintDevice(cs);
+    device->convertFromQImage(qimage, 0, 0, 0);
+
+    KisPaintLayerSP layer = new KisPaintLayer(image, 0, 100, device);
+    image->addNode(layer);
+
+    /**
+     * Three unselected color masks are applied in a single pass,
+     * the result should be the same as applying them one by one
+     */
+    for (int i = 0; i < 3; i++) {
+        KisFilterConfigurationSP kfc = f->defaultConfiguration();
+        Q_ASSERT(kfc);
+
+        KisFilterMaskSP mask = new KisFilterMask();
+        mask->setFilter(kfc);
+        mask->createNodeProgressProxy();
+        image->addNode(mask, layer);
+    }
+
+    layer->setDirty(qimage.rect());
+    image->waitForDone();
+
+    QPoint errpoint;
+    if (!TestUtil::compareQImages(errpoint, inverted, layer->projection()->convertToQImage(0, 0, 0, qimage.width(), qimage.height()))) {
+        layer->projection()->convertToQImage(0, 0, 0, qimage.width(), qimage.height()).save("filtermasktest3.png");
+        QFAIL(QString("Failed to create inverted image, first different pixel: %1,%2 ").arg(errpoint.x()).arg(errpoint.y()).toLatin1());
+    }
+}
+
+void KisFilterMaskTest::testFusedColorMasksWithSelection()
+{
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    QImage qimage(QString(FILES_DATA_DIR) + QDir::separator() + "hakonepa.png");
+    QImage inverted(QString(FILES_DATA_DIR) + QDir::separator() + "inverted_hakonepa.png");
+
+    KisFilterSP f = KisFilterRegistry::instance()->value("invert");
+    Q_ASSERT(f);
+
+    KisImageSP image = new KisImage(0, IMAGE_WIDTH, IMAGE_HEIGHT, cs, "tests");
+    KisPaintDeviceSP device = new KisPaintDevice(cs);
+    device->convertFromQImage(qimage, 0, 0, 0);
+
+    KisPaintLayerSP layer = new KisPaintLayer(image, 0, 100, device);
+    image->addNode(layer);
+
+    /**
+     * The masks are created the same way as in the UI, so each of them
+     * gets a selection with a fully selected default pixel
+     */
+    QList<KisFilterMaskSP> masks;
+    for (int i = 0; i < 3; i++) {
+        KisFilterConfigurationSP kfc = f->defaultConfiguration();
+        Q_ASSERT(kfc);
+
+        KisFilterMaskSP mask = new KisFilterMask();
+        mask->initSelection(layer);
+        mask->setFilter(kfc);
+        mask->createNodeProgressProxy();
+        image->addNode(mask, layer);
+
+        QVERIFY(mask->selection());
+        masks << mask;
+    }
+
+    const QRect rc = qimage.rect();
+
+    Q_FOREACH (KisFilterMaskSP mask, masks) {
+        QVERIFY(mask->fusableColorFilter(layer->projection(), rc));
+    }
+
+    layer->setDirty(rc);
+    image->waitForDone();
+
+    QPoint errpoint;
+    if (!TestUtil::compareQImages(errpoint, inverted, layer->projection()->convertToQImage(0, 0, 0, qimage.width(), qimage.height()))) {
+        layer->projection()->convertToQImage(0, 0, 0, qimage.width(), qimage.height()).save("filtermasktest4.png");
+        QFAIL(QString("Failed to create inverted image, first different pixel: %1,%2 ").arg(errpoint.x()).arg(errpoint.y()).toLatin1());
+    }
+
+    // explicitly selected pixels are still a full selection
+    masks[1]->select(QRect(100, 100, 200, 200), MAX_SELECTED);
+    QVERIFY(masks[1]->fusableColorFilter(layer->projection(), rc));
+
+    // a partially selected mask should go through the usual path
+    masks[1]->select(QRect(100, 100, 200, 200), MIN_SELECTED);
+    QVERIFY(!masks[1]->fusableColorFilter(layer->projection(), rc));
+    QVERIFY(masks[1]->fusableColorFilter(layer->projection(), QRect(400, 400, 100, 100)));
+}
+
 QTEST_MAIN(KisFilterMaskTest)
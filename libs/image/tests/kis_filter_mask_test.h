@@ -32,6 +32,8 @@ private Q_SLOTS:
     void testCreation();
     void testProjectionNotSelected();
     void testProjectionSelected();
+    void testFusedColorMasks();
+    void testFusedColorMasksWithSelection();
 
 };
 
@@ -311,6 +311,48 @@ void KisImageTest::testCloneImage()
     }
 }
 
+#include "kis_datamanager.h"
+
+void KisImageTest::testCloneImageSharesPixelData()
+{
+    KisImageSP image = new KisImage(0, IMAGE_WIDTH, IMAGE_WIDTH, 0, "layer tests");
+
+    KisPaintLayerSP layer = new KisPaintLayer(image, "layer1", OPACITY_OPAQUE_U8);
+    image->addNode(layer);
+
+    const KoColor red(Qt::red, image->colorSpace());
+    const KoColor blue(Qt::blue, image->colorSpace());
+    layer->paintDevice()->fill(QRect(0, 0, 64, 64), red);
+
+    // make sure the next names are not reused in the clone
+    image->nextLayerName("Paint Layer");
+
+    KisImageSP newImage = image->clone(true);
+    KisNodeSP newLayer = TestUtil::findNode(newImage->root(), "layer1");
+    QVERIFY(newLayer);
+
+    KisDataManagerSP dm = layer->paintDevice()->dataManager();
+    KisDataManagerSP newDm = newLayer->paintDevice()->dataManager();
+
+    // the clone references the same tile data until someone writes into it
+    QCOMPARE(newDm->getTile(0, 0, false)->tileData(),
+             dm->getTile(0, 0, false)->tileData());
+
+    newLayer->paintDevice()->fill(QRect(0, 0, 64, 64), blue);
+
+    QVERIFY(newDm->getTile(0, 0, false)->tileData() !=
+            dm->getTile(0, 0, false)->tileData());
+
+    KoColor pixel(image->colorSpace());
+    layer->paintDevice()->pixel(10, 10, &pixel);
+    QCOMPARE(pixel, red);
+    newLayer->paintDevice()->pixel(10, 10, &pixel);
+    QCOMPARE(pixel, blue);
+
+    QCOMPARE(newImage->nextLayerName("Paint Layer"),
+             image->nextLayerName("Paint Layer"));
+}
+
 void KisImageTest::testLayerComposition()
 {
     KisImageSP image = new KisImage(0, IMAGE_WIDTH, IMAGE_WIDTH, 0, "layer tests");
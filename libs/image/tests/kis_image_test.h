@@ -34,6 +34,7 @@ private Q_SLOTS:
     void testConvertImageColorSpace();
     void testGlobalSelection();
     void testCloneImage();
+    void testCloneImageSharesPixelData();
     void testLayerComposition();
 
     void testFlattenLayer();
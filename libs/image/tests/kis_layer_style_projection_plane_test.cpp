@@ -496,4 +496,133 @@ void KisLayerStyleProjectionPlaneTest::testBevel()
     style->bevelAndEmboss()->setSoften(3);
     test(style, "bevel_pillow_up_soft");
 }
+#include "layerstyles/kis_layer_style_filter_environment.h"
+#include "layerstyles/kis_ls_drop_shadow_filter.h"
+#include "layerstyles/kis_multiple_projection.h"
+
+KisPaintDeviceSP renderDropShadow(KisPaintLayerSP layer, KisPSDLayerStyleSP style,
+                                  KisLayerStyleFilterEnvironment *env, const QRect &rect)
+{
+    KisLsDropShadowFilter filter(KisLsDropShadowFilter::DropShadow);
+    KisMultipleProjection projection;
+
+    filter.processDirectly(layer->projection(), &projection, rect, style, env);
+
+    KisPaintDeviceSP result = new KisPaintDevice(layer->colorSpace());
+    projection.apply(result, rect, env);
+
+    return result;
+}
+
+/**
+ * Checks that the shadow rendered with the environment that has been
+ * used before (and, therefore, has the selection cached) is the same as
+ * the one rendered from scratch
+ */
+bool checkCachedDropShadow(KisPaintLayerSP layer, KisPSDLayerStyleSP style,
+                           KisLayerStyleFilterEnvironment *cachedEnv, const QRect &rect)
+{
+    KisLayerStyleFilterEnvironment freshEnv(layer.data());
+
+    KisPaintDeviceSP cached = renderDropShadow(layer, style, cachedEnv, rect);
+    KisPaintDeviceSP fresh = renderDropShadow(layer, style, &freshEnv, rect);
+
+    QPoint errpoint;
+    if (!TestUtil::compareQImages(errpoint,
+                                  fresh->convertToQImage(0, rect),
+                                  cached->convertToQImage(0, rect))) {
+
+        qDebug() << "Cached shadow differs at" << errpoint;
+        return false;
+    }
+
+    return true;
+}
+
+void KisLayerStyleProjectionPlaneTest::testShadowSelectionCache()
+{
+    const QRect imageRect(0, 0, 200, 200);
+    const QRect updateRect(0, 0, 80, 80);
+
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "styles test");
+
+    KisPaintLayerSP layer = new KisPaintLayer(image, "test", OPACITY_OPAQUE_U8);
+    image->addNode(layer);
+
+    layer->paintDevice()->fill(QRect(20, 20, 40, 40), KoColor(Qt::red, cs));
+
+    KisPSDLayerStyleSP style(new KisPSDLayerStyle());
+    style->dropShadow()->setSize(10);
+    style->dropShadow()->setSpread(20);
+    style->dropShadow()->setDistance(5);
+    style->dropShadow()->setOpacity(70);
+    style->dropShadow()->setNoise(0);
+    style->dropShadow()->setEffectEnabled(true);
+
+    KisLayerStyleFilterEnvironment env(layer.data());
+
+    // fill the cache
+    renderDropShadow(layer, style, &env, imageRect);
+
+    // the alpha has changed inside the need rect, the shadow must be recalculated
+    layer->paintDevice()->fill(QRect(65, 30, 10, 10), KoColor(Qt::red, cs));
+    QVERIFY(checkCachedDropShadow(layer, style, &env, updateRect));
+
+    // the alpha has changed far from the update, the cached selection is reused
+    layer->paintDevice()->fill(QRect(170, 170, 20, 20), KoColor(Qt::red, cs));
+    QVERIFY(checkCachedDropShadow(layer, style, &env, updateRect));
+
+    // only the color has changed, the cached selection is reused
+    layer->paintDevice()->fill(QRect(20, 20, 40, 40), KoColor(Qt::blue, cs));
+    QVERIFY(checkCachedDropShadow(layer, style, &env, updateRect));
+
+    // the parameters have changed, the cached selection must be ignored
+    style->dropShadow()->setSize(15);
+    QVERIFY(checkCachedDropShadow(layer, style, &env, updateRect));
+
+    style->dropShadow()->setSpread(50);
+    QVERIFY(checkCachedDropShadow(layer, style, &env, updateRect));
+}
+
+void KisLayerStyleProjectionPlaneTest::testEffectSelectionCache()
+{
+    const QRect alphaRect(0, 0, 150, 150);
+    const QRect resultRect(20, 20, 110, 110);
+
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, 200, 200, cs, "styles test");
+    KisPaintLayerSP layer = new KisPaintLayer(image, "test", OPACITY_OPAQUE_U8);
+
+    KisLayerStyleFilterEnvironment env(layer.data());
+
+    KisPixelSelectionSP alpha = new KisPixelSelection();
+    alpha->select(QRect(50, 50, 50, 50));
+
+    KisPixelSelectionSP result = new KisPixelSelection();
+    result->select(QRect(40, 40, 70, 70), 128);
+
+    env.storeCachedEffectSelection("params", alpha, alphaRect, result, resultRect);
+
+    KisPixelSelectionSP cached = env.fetchCachedEffectSelection("params", alpha, alphaRect, resultRect);
+    QVERIFY(cached);
+    QCOMPARE(cached->selectedExactRect(), QRect(40, 40, 70, 70));
+
+    // a different set of parameters
+    QVERIFY(!env.fetchCachedEffectSelection("other params", alpha, alphaRect, resultRect));
+
+    // the alpha changed outside the need rect
+    KisPixelSelectionSP farChangedAlpha = new KisPixelSelection(*alpha);
+    farChangedAlpha->select(QRect(170, 170, 10, 10));
+    QVERIFY(env.fetchCachedEffectSelection("params", farChangedAlpha, alphaRect, resultRect));
+
+    // the alpha changed inside the need rect
+    KisPixelSelectionSP changedAlpha = new KisPixelSelection(*alpha);
+    changedAlpha->select(QRect(10, 10, 5, 5));
+    QVERIFY(!env.fetchCachedEffectSelection("params", changedAlpha, alphaRect, resultRect));
+
+    // the rect hasn't been cached yet
+    QVERIFY(!env.fetchCachedEffectSelection("params", alpha, alphaRect, resultRect.adjusted(0, 0, 10, 10)));
+}
+
 QTEST_MAIN(KisLayerStyleProjectionPlaneTest)
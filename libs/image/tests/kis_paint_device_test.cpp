@@ -794,6 +794,31 @@ void KisPaintDeviceTest::testNonDefaultPixelArea()
     QCOMPARE(dev->nonDefaultPixelArea(), fillRect | QRect(100,100,1,1));
 }
 
+void KisPaintDeviceTest::testExactBoundsSparse()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+
+    const KoColor color(Qt::white, cs);
+
+    dev->setPixel(1000, 2000, color);
+    dev->setPixel(3000, 100, color);
+    QCOMPARE(dev->exactBounds(), QRect(1000, 100, 2001, 1901));
+
+    // allocated, but fully transparent tiles should not count
+    dev->fill(QRect(5000, 5000, 200, 200), color);
+    dev->clear(QRect(5000, 5000, 200, 200));
+    QCOMPARE(dev->exactBounds(), QRect(1000, 100, 2001, 1901));
+    QCOMPARE(dev->nonDefaultPixelArea(), QRect(1000, 100, 2001, 1901));
+
+    // pixels inside the known bounds don't change them
+    dev->setPixel(2000, 1000, color);
+    QCOMPARE(dev->exactBounds(), QRect(1000, 100, 2001, 1901));
+
+    dev->setPixel(-10, 1000, color);
+    QCOMPARE(dev->exactBounds(), QRect(-10, 100, 3011, 1901));
+}
+
 void KisPaintDeviceTest::testExactBoundsNonTransparent()
 {
     const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
@@ -51,6 +51,7 @@ private Q_SLOTS:
     void benchmarkExactBoundsNullDefaultPixel();
     void testAmortizedExactBounds();
     void testNonDefaultPixelArea();
+    void testExactBoundsSparse();
     void testExactBoundsNonTransparent();
 
     void testReadBytesWrapAround();
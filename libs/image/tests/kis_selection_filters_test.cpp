@@ -0,0 +1,132 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_selection_filters_test.h"
+
+#include <QTest>
+
+#include "kis_pixel_selection.h"
+#include "kis_selection_filters.h"
+
+
+enum FilterType {
+    Grow,
+    Shrink,
+    ShrinkEdgeLock
+};
+
+void KisSelectionFiltersTest::testBinaryPath_data()
+{
+    QTest::addColumn<int>("filterType");
+    QTest::addColumn<int>("xRadius");
+    QTest::addColumn<int>("yRadius");
+
+    const QVector<QPair<int, int>> radii = {
+        {1, 1}, {1, 3}, {3, 1}, {2, 5}, {4, 4}, {7, 2}, {10, 10}, {25, 17}
+    };
+
+    for (auto it = radii.constBegin(); it != radii.constEnd(); ++it) {
+        const QString suffix = QString("%1x%2").arg(it->first).arg(it->second);
+
+        QTest::newRow(qPrintable("grow-" + suffix)) << int(Grow) << it->first << it->second;
+        QTest::newRow(qPrintable("shrink-" + suffix)) << int(Shrink) << it->first << it->second;
+        QTest::newRow(qPrintable("shrink-edge-lock-" + suffix)) << int(ShrinkEdgeLock) << it->first << it->second;
+    }
+}
+
+static KisSelectionFilter* createFilter(int filterType, int xRadius, int yRadius)
+{
+    switch (filterType) {
+    case Grow:
+        return new KisGrowSelectionFilter(xRadius, yRadius);
+    case Shrink:
+        return new KisShrinkSelectionFilter(xRadius, yRadius, false);
+    default:
+        return new KisShrinkSelectionFilter(xRadius, yRadius, true);
+    }
+}
+
+/**
+ * The binary selections are processed with a separate algorithm. The
+ * test runs the same binary selection through it and through the generic
+ * one and checks that the results are identical.
+ */
+void KisSelectionFiltersTest::testBinaryPath()
+{
+    QFETCH(int, filterType);
+    QFETCH(int, xRadius);
+    QFETCH(int, yRadius);
+
+    const QRect rect(10, 20, 300, 200);
+
+    KisPixelSelectionSP binary = new KisPixelSelection();
+
+    binary->select(QRect(30, 40, 100, 50));
+    binary->select(QRect(150, 20, 3, 200));
+    binary->select(QRect(10, 150, 300, 1));
+    binary->select(QRect(200, 60, 60, 60));
+    binary->clear(QRect(220, 80, 20, 20));
+
+    qsrand(1);
+    for (int i = 0; i < 500; i++) {
+        binary->select(QRect(rect.x() + qrand() % rect.width(),
+                             rect.y() + qrand() % rect.height(),
+                             1 + qrand() % 3, 1 + qrand() % 3));
+        binary->clear(QRect(rect.x() + qrand() % rect.width(),
+                            rect.y() + qrand() % rect.height(),
+                            1 + qrand() % 3, 1 + qrand() % 3));
+    }
+
+    /**
+     * A single semi-transparent pixel makes the selection non-binary,
+     * so the generic algorithm is used for it. The area it can affect
+     * is excluded from the comparison.
+     */
+    const QPoint semiSelectedPixel(rect.right(), rect.bottom());
+    const QRect excludedRect =
+        QRect(semiSelectedPixel, QSize(1, 1)).adjusted(-xRadius, -yRadius, xRadius, yRadius);
+
+    KisPixelSelectionSP generic = new KisPixelSelection(*binary);
+    generic->select(QRect(semiSelectedPixel, QSize(1, 1)), 128);
+
+    QScopedPointer<KisSelectionFilter> filter(createFilter(filterType, xRadius, yRadius));
+    filter->process(binary, rect);
+    filter->process(generic, rect);
+
+    QVector<quint8> binaryBytes(rect.width() * rect.height());
+    QVector<quint8> genericBytes(rect.width() * rect.height());
+    binary->readBytes(binaryBytes.data(), rect);
+    generic->readBytes(genericBytes.data(), rect);
+
+    for (int y = 0; y < rect.height(); y++) {
+        for (int x = 0; x < rect.width(); x++) {
+            const QPoint pt(rect.x() + x, rect.y() + y);
+            if (excludedRect.contains(pt)) continue;
+
+            const int index = y * rect.width() + x;
+
+            if (binaryBytes[index] != genericBytes[index]) {
+                QFAIL(qPrintable(QString("Pixel (%1, %2) differs: binary %3, generic %4")
+                                 .arg(pt.x()).arg(pt.y())
+                                 .arg(binaryBytes[index]).arg(genericBytes[index])));
+            }
+        }
+    }
+}
+
+QTEST_MAIN(KisSelectionFiltersTest)
@@ -680,6 +680,34 @@ QRegion KisTiledDataManager::region() const
     return region;
 }
 
+bool KisTiledDataManager::sharesTileDataWith(const KisTiledDataManager *other) const
+{
+    if (other == this) return true;
+
+    QReadLocker locker(&m_lock);
+    QReadLocker otherLocker(&other->m_lock);
+
+    if (m_pixelSize != other->m_pixelSize ||
+        m_hashTable->numTiles() != other->m_hashTable->numTiles()) {
+
+        return false;
+    }
+
+    KisTileHashTableConstIterator iter(m_hashTable);
+    KisTileSP tile;
+
+    while ((tile = iter.tile())) {
+        KisTileSP otherTile = other->m_hashTable->getExistingTile(tile->col(), tile->row());
+
+        if (!otherTile || otherTile->tileData() != tile->tileData()) {
+            return false;
+        }
+        iter.next();
+    }
+
+    return true;
+}
+
 void KisTiledDataManager::setPixel(qint32 x, qint32 y, const quint8 * data)
 {
     KisTileDataWrapper tw(this, x, y, KisTileDataWrapper::WRITE);
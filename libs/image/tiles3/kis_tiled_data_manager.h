@@ -228,6 +228,15 @@ public:
 
     QRegion region() const;
 
+    /**
+     * Returns true if every tile of the data manager references exactly
+     * the same tile data as the corresponding tile of \p other. It
+     * happens when one of the managers is a copy of the other one and
+     * none of them has been written into since then, so the content of
+     * the two managers is guaranteed to be equal.
+     */
+    bool sharesTileDataWith(const KisTiledDataManager *other) const;
+
     void clear(QRect clearRect, quint8 clearValue);
     void clear(QRect clearRect, const quint8 *clearPixel);
     void clear(qint32 x, qint32 y, qint32 w, qint32 h, quint8 clearValue);
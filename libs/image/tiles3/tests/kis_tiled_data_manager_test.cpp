@@ -214,6 +214,31 @@ void KisTiledDataManagerTest::testUnversionedBitBlt()
     QVERIFY(checkTilesShared(&srcDM, &dstDM, false, false, tilesRect));
 }
 
+void KisTiledDataManagerTest::testSharesTileData()
+{
+    quint8 defaultPixel = 0;
+    KisTiledDataManager srcDM(1, &defaultPixel);
+
+    quint8 oddPixel1 = 128;
+    quint8 oddPixel2 = 129;
+
+    srcDM.clear(QRect(0,0,512,512), &oddPixel1);
+
+    KisTiledDataManager dstDM(srcDM);
+    QVERIFY(dstDM.sharesTileDataWith(&srcDM));
+    QVERIFY(srcDM.sharesTileDataWith(&dstDM));
+
+    // writing detaches the tile
+    dstDM.setPixel(100, 100, &oddPixel2);
+    QVERIFY(!dstDM.sharesTileDataWith(&srcDM));
+    QVERIFY(!srcDM.sharesTileDataWith(&dstDM));
+
+    // a new tile makes the sets of tiles different
+    KisTiledDataManager extendedDM(srcDM);
+    extendedDM.setPixel(600, 600, &oddPixel2);
+    QVERIFY(!extendedDM.sharesTileDataWith(&srcDM));
+}
+
 void KisTiledDataManagerTest::testVersionedBitBlt()
 {
     quint8 defaultPixel = 0;
@@ -414,6 +414,33 @@ void Node::setVisible(bool visible)
 }
 
 
+bool Node::readPixelData(quint8 *data, qint64 size, int x, int y, int w, int h) const
+{
+    if (!d->node) return false;
+
+    KisPaintDeviceSP dev = d->node->paintDevice();
+    if (!dev) return false;
+
+    if (w < 0 || h < 0 || size < qint64(w) * h * dev->pixelSize()) return false;
+
+    dev->readBytes(data, x, y, w, h);
+    return true;
+}
+
+bool Node::writePixelData(const quint8 *data, qint64 size, int x, int y, int w, int h)
+{
+    if (!d->node) return false;
+
+    KisPaintDeviceSP dev = d->node->paintDevice();
+    if (!dev) return false;
+
+    if (w < 0 || h < 0 || size < qint64(w) * h * dev->pixelSize()) return false;
+
+    dev->writeBytes(data, x, y, w, h);
+    d->node->setDirty(QRect(x, y, w, h));
+    return true;
+}
+
 QByteArray Node::pixelData(int x, int y, int w, int h) const
 {
     QByteArray ba;
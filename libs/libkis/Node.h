@@ -41,6 +41,28 @@ public:
     bool operator==(const Node &other) const;
     bool operator!=(const Node &other) const;
 
+    /**
+     * @brief readPixelData reads the given rectangle from the Node's paintable pixels
+     * directly into @p data, using the same layout as pixelData(). Unlike pixelData(),
+     * no intermediate byte array is created, so the scripting bindings can read into
+     * a Python buffer (e.g. a NumPy array) in place.
+     *
+     * @param data the buffer to write the pixels to
+     * @param size the size of @p data in bytes
+     * @return false if the node has no pixel data or @p data is too small
+     */
+    bool readPixelData(quint8 *data, qint64 size, int x, int y, int w, int h) const;
+
+    /**
+     * @brief writePixelData writes the pixels from @p data into the given rectangle
+     * of the Node, the same way as setPixelData() does, and marks the rectangle dirty.
+     *
+     * @param data the buffer to read the pixels from
+     * @param size the size of @p data in bytes
+     * @return false if the node has no writable pixel data or @p data is too small
+     */
+    bool writePixelData(const quint8 *data, qint64 size, int x, int y, int w, int h);
+
 public Q_SLOTS:
 
     /**
@@ -95,6 +95,44 @@ void TestNode::testPixelData()
     }
 }
 
+void TestNode::testReadWritePixelData()
+{
+    KisImageSP image = new KisImage(0, 100, 100, KoColorSpaceRegistry::instance()->rgb8(), "test");
+    KisNodeSP layer = new KisPaintLayer(image, "test1", 255);
+    KisFillPainter gc(layer->paintDevice());
+    gc.fillRect(0, 0, 100, 100, KoColor(Qt::red, layer->colorSpace()));
+    Node node(image, layer);
+
+    QVector<quint8> buffer(100 * 100 * 4);
+    QVERIFY(!node.readPixelData(buffer.data(), buffer.size() - 1, 0, 0, 100, 100));
+    QVERIFY(node.readPixelData(buffer.data(), buffer.size(), 0, 0, 100, 100));
+
+    for (int i = 0; i < 100 * 100; i++) {
+        QCOMPARE(buffer[4 * i + 0], quint8(0));
+        QCOMPARE(buffer[4 * i + 1], quint8(0));
+        QCOMPARE(buffer[4 * i + 2], quint8(255));
+        QCOMPARE(buffer[4 * i + 3], quint8(255));
+    }
+
+    buffer.fill(255);
+    for (int i = 0; i < 100 * 100; i++) {
+        buffer[4 * i + 0] = 0;
+        buffer[4 * i + 1] = 0;
+        buffer[4 * i + 2] = 0;
+    }
+
+    QVERIFY(!node.writePixelData(buffer.data(), buffer.size() - 1, 0, 0, 100, 100));
+    QVERIFY(node.writePixelData(buffer.data(), buffer.size(), 0, 0, 100, 100));
+
+    for (int i = 0; i < 100 ; i++) {
+        for (int j = 0; j < 100 ; j++) {
+            QColor pixel;
+            layer->paintDevice()->pixel(i, j, &pixel);
+            QVERIFY(pixel == QColor(Qt::black));
+        }
+    }
+}
+
 void TestNode::testProjectionPixelData()
 {
     KisImageSP image = new KisImage(0, 100, 100, KoColorSpaceRegistry::instance()->rgb8(), "test");
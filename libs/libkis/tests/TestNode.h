@@ -28,6 +28,7 @@ private Q_SLOTS:
     void testSetColorSpace();
     void testSetColorProfile();
     void testPixelData();
+    void testReadWritePixelData();
     void testProjectionPixelData();
     void testThumbnail();
     void testMergeDown();
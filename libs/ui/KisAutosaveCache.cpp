@@ -0,0 +1,73 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+#include "KisAutosaveCache.h"
+
+#include <QHash>
+#include "kis_paint_device.h"
+#include "kis_datamanager.h"
+
+
+struct KisAutosaveCache::Private
+{
+    struct Stream {
+        KisDataManagerSP snapshot;
+        QString location;
+    };
+
+    QString filePath;
+    QHash<QString, Stream> streams;
+};
+
+KisAutosaveCache::KisAutosaveCache(const QString &filePath)
+    : m_d(new Private)
+{
+    m_d->filePath = filePath;
+}
+
+KisAutosaveCache::~KisAutosaveCache()
+{
+}
+
+QString KisAutosaveCache::filePath() const
+{
+    return m_d->filePath;
+}
+
+QString KisAutosaveCache::unchangedStreamLocation(const QString &key, KisPaintDeviceSP device) const
+{
+    auto it = m_d->streams.constFind(key);
+    if (it == m_d->streams.constEnd()) return QString();
+
+    return device->dataManager()->sharesTileDataWith(it->snapshot.data()) ?
+        it->location : QString();
+}
+
+void KisAutosaveCache::addStream(const QString &key, KisPaintDeviceSP device, const QString &location)
+{
+    Private::Stream stream;
+
+    /**
+     * The copy shares all the tiles with the device, so it costs nothing
+     * until the device is painted on. The tiles that are changed after that
+     * are detached from the copy, which is exactly how we detect changes.
+     */
+    stream.snapshot = new KisDataManager(*device->dataManager());
+    stream.location = location;
+
+    m_d->streams.insert(key, stream);
+}
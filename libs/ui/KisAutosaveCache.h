@@ -0,0 +1,68 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+#ifndef KISAUTOSAVECACHE_H
+#define KISAUTOSAVECACHE_H
+
+#include "kritaui_export.h"
+#include <QScopedPointer>
+#include <QSharedPointer>
+#include "kis_types.h"
+
+/**
+ * Remembers which pixel data streams have been written into an autosave
+ * file. Together with every stream the cache keeps a copy-on-write copy
+ * of the saved device, so the next autosave can find out cheaply whether
+ * the device has been changed since then and, if not, copy the already
+ * compressed stream from the previous file instead of serializing the
+ * device again.
+ *
+ * The streams are identified by a key that must be stable between the
+ * clones of the document, e.g. the UUID of the owning node.
+ */
+class KRITAUI_EXPORT KisAutosaveCache
+{
+public:
+    KisAutosaveCache(const QString &filePath);
+    ~KisAutosaveCache();
+
+    /**
+     * The autosave file the streams have been written into
+     */
+    QString filePath() const;
+
+    /**
+     * Returns the location of the stream saved under \p key if its
+     * content is still equal to the content of \p device. Otherwise
+     * returns an empty string.
+     */
+    QString unchangedStreamLocation(const QString &key, KisPaintDeviceSP device) const;
+
+    /**
+     * Remembers that \p device has been saved into \p location
+     * of filePath() under \p key
+     */
+    void addStream(const QString &key, KisPaintDeviceSP device, const QString &location);
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+typedef QSharedPointer<KisAutosaveCache> KisAutosaveCacheSP;
+
+#endif // KISAUTOSAVECACHE_H
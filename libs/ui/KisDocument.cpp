@@ -117,6 +117,7 @@
 #include "kis_config_notifier.h"
 #include "kis_async_action_feedback.h"
 #include "KisCloneDocumentStroke.h"
+#include "kis_pointer_utils.h"
 
 
 // Define the protocol used here for embedded documents' URL
@@ -293,6 +294,8 @@ public:
     bool modifiedAfterAutosave = false;
     bool isAutosaving = false;
     bool disregardAutosaveFailure = false;
+    KisAutosaveCacheSP autosaveCache;
+    KisAutosaveCacheSP pendingAutosaveCache;
     int autoSaveFailureCount = 0;
 
     KUndo2Stack *undoStack = 0;
@@ -743,6 +746,13 @@ bool KisDocument::initiateSavingInBackground(const QString actionName,
 
     if (d->backgroundSaveJob.flags & KritaUtils::SaveInAutosaveMode) {
         d->backgroundSaveDocument->d->isAutosaving = true;
+
+        // the saver may reuse the unchanged streams of the file it overwrites
+        if (d->autosaveCache && d->autosaveCache->filePath() == job.filePath) {
+            d->backgroundSaveDocument->d->autosaveCache = d->autosaveCache;
+        }
+        d->backgroundSaveDocument->d->pendingAutosaveCache =
+            toQShared(new KisAutosaveCache(job.filePath));
     }
 
     connect(d->backgroundSaveDocument.data(),
@@ -787,6 +797,11 @@ void KisDocument::slotChildCompletedSavingInBackground(KisImportExportFilter::Co
 
     if (d->backgroundSaveJob.flags & KritaUtils::SaveInAutosaveMode) {
         d->backgroundSaveDocument->d->isAutosaving = false;
+
+        d->autosaveCache =
+            status == KisImportExportFilter::OK ?
+            d->backgroundSaveDocument->d->pendingAutosaveCache :
+            KisAutosaveCacheSP();
     }
 
     d->backgroundSaveDocument.take()->deleteLater();
@@ -1391,6 +1406,9 @@ QString KisDocument::warningMessage() const
 
 void KisDocument::removeAutoSaveFiles()
 {
+    // the streams of the removed files cannot be reused anymore
+    d->autosaveCache.clear();
+
     //qDebug() << "removeAutoSaveFiles";
     // Eliminate any auto-save file
     QString asf = generateAutoSaveFileName(localFilePath());   // the one in the current dir
@@ -1790,6 +1808,21 @@ bool KisDocument::isAutosaving() const
     return d->isAutosaving;
 }
 
+KisAutosaveCacheSP KisDocument::autosaveCache() const
+{
+    return d->autosaveCache;
+}
+
+KisAutosaveCacheSP KisDocument::pendingAutosaveCache() const
+{
+    return d->pendingAutosaveCache;
+}
+
+void KisDocument::discardAutosaveCache()
+{
+    d->autosaveCache.clear();
+}
+
 QString KisDocument::exportErrorToUserMessage(KisImportExportFilter::ConversionStatus status, const QString &errorMessage)
 {
     return errorMessage.isEmpty() ? KisImportExportFilter::conversionStatusString(status) : errorMessage;
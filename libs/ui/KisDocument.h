@@ -39,6 +39,7 @@
 #include <KisReferenceImage.h>
 #include <kis_debug.h>
 #include <KisImportExportUtils.h>
+#include <KisAutosaveCache.h>
 
 #include "kritaui_export.h"
 
@@ -507,6 +508,26 @@ public:
 
     bool isAutosaving() const override;
 
+    /**
+     * The streams written into the autosave file by the last successful
+     * autosave. When called on the document being autosaved, the streams
+     * of the previous autosave file, which the saver may copy if the
+     * corresponding devices haven't been changed.
+     */
+    KisAutosaveCacheSP autosaveCache() const;
+
+    /**
+     * The streams written by the autosave that is currently in progress
+     * (only valid for the document being autosaved)
+     */
+    KisAutosaveCacheSP pendingAutosaveCache() const;
+
+    /**
+     * Makes the saver write all the devices in full instead of copying
+     * them from the previous autosave file
+     */
+    void discardAutosaveCache();
+
 public:
 
     QString localFilePath() const override;
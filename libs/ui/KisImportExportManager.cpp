@@ -618,6 +618,18 @@ KisImportExportFilter::ConversionStatus KisImportExportManager::doExportImpl(con
         return KisImportExportFilter::CreationError;
     }
 
+    /**
+     * When QSaveFile cannot create a temporary file next to the target,
+     * it falls back to writing into the target directly. Autosaving may
+     * copy the unchanged layers from the previous version of that very
+     * file, so it must save everything in full in such a case.
+     */
+    if (filter->supportsIO() && m_document->isAutosaving() &&
+        !QFileInfo(QFileInfo(location).absolutePath()).isWritable()) {
+
+        m_document->discardAutosaveCache();
+    }
+
     KisImportExportFilter::ConversionStatus status =
             filter->convert(m_document, &file, exportConfiguration);
 
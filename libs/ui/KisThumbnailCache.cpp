@@ -0,0 +1,179 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+#include "KisThumbnailCache.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QImage>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QThreadPool>
+#include <QUrl>
+#include <QtConcurrent>
+
+#include <KoStore.h>
+
+#include "kis_debug.h"
+
+Q_GLOBAL_STATIC(KisThumbnailCache, s_instance)
+
+struct KisThumbnailCache::Private
+{
+    QString cacheDir;
+    qint64 maxCacheSize;
+    QThreadPool threadPool;
+    QMutex trimMutex;
+};
+
+KisThumbnailCache::KisThumbnailCache()
+    : KisThumbnailCache(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/thumbnails",
+                        50 * 1024 * 1024)
+{
+}
+
+KisThumbnailCache::KisThumbnailCache(const QString &cacheDir, qint64 maxCacheSize)
+    : m_d(new Private)
+{
+    m_d->cacheDir = cacheDir;
+    m_d->maxCacheSize = maxCacheSize;
+    QDir().mkpath(m_d->cacheDir);
+
+    // the thumbnails are usually read from the disk or the network,
+    // so there is no reason to run more threads
+    m_d->threadPool.setMaxThreadCount(2);
+}
+
+KisThumbnailCache::~KisThumbnailCache()
+{
+    m_d->threadPool.clear();
+    m_d->threadPool.waitForDone();
+}
+
+KisThumbnailCache *KisThumbnailCache::instance()
+{
+    return s_instance;
+}
+
+void KisThumbnailCache::requestThumbnail(const QString &url, int size)
+{
+    QtConcurrent::run(&m_d->threadPool,
+        [this, url, size] () {
+            const QImage thumbnail = fetchThumbnail(url, size);
+            emit sigThumbnailReady(url, thumbnail);
+        });
+}
+
+QImage KisThumbnailCache::fetchThumbnail(const QString &url, int size)
+{
+    const QUrl fileUrl(url);
+    QString cachePath;
+
+    if (fileUrl.isLocalFile()) {
+        const QFileInfo info(fileUrl.toLocalFile());
+        if (!info.exists()) return QImage();
+
+        const QString key = QString("%1\n%2\n%3")
+            .arg(info.absoluteFilePath())
+            .arg(info.lastModified().toMSecsSinceEpoch())
+            .arg(size);
+
+        cachePath = m_d->cacheDir + "/" +
+            QString::fromLatin1(QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Md5).toHex()) +
+            ".png";
+
+        QImage image;
+        if (image.load(cachePath, "PNG")) {
+            /**
+             * The modification time of the entry is used for LRU
+             * eviction, so refresh it from time to time. The entry may
+             * be read by another thread meanwhile, so it is rewritten
+             * atomically.
+             */
+            if (QFileInfo(cachePath).lastModified().daysTo(QDateTime::currentDateTime()) > 0) {
+                saveEntry(image, cachePath);
+            }
+            return image;
+        }
+    }
+
+    QImage image;
+
+    // almost all Krita-supported formats save a thumbnail
+    QScopedPointer<KoStore> store(KoStore::createStore(fileUrl, KoStore::Read));
+    if (store &&
+        (store->open(QString("Thumbnails/thumbnail.png")) ||
+         store->open(QString("preview.png")))) {
+
+        QByteArray bytes = store->read(store->size());
+        store->close();
+        image.loadFromData(bytes);
+    }
+
+    if (image.isNull()) return image;
+
+    if (image.width() > size || image.height() > size) {
+        image = image.scaled(size, size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    }
+
+    if (!cachePath.isEmpty() && saveEntry(image, cachePath)) {
+        trimCache();
+    }
+
+    return image;
+}
+
+bool KisThumbnailCache::saveEntry(const QImage &image, const QString &cachePath)
+{
+    QSaveFile file(cachePath);
+    if (file.open(QIODevice::WriteOnly) &&
+        image.save(&file, "PNG") &&
+        file.commit()) {
+
+        return true;
+    }
+
+    warnKrita << "Failed to save the thumbnail cache entry" << cachePath;
+    return false;
+}
+
+void KisThumbnailCache::trimCache()
+{
+    QMutexLocker l(&m_d->trimMutex);
+
+    QDir dir(m_d->cacheDir);
+    QFileInfoList entries =
+        dir.entryInfoList(QStringList() << "*.png", QDir::Files, QDir::Time);
+
+    qint64 totalSize = 0;
+    Q_FOREACH (const QFileInfo &info, entries) {
+        totalSize += info.size();
+    }
+
+    if (totalSize <= m_d->maxCacheSize) return;
+
+    // remove a bit more than needed to not trim on every new entry
+    while (totalSize > m_d->maxCacheSize * 3 / 4 && !entries.isEmpty()) {
+        const QFileInfo info = entries.takeLast();
+        totalSize -= info.size();
+        QFile::remove(info.absoluteFilePath());
+    }
+}
@@ -0,0 +1,79 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+#ifndef KISTHUMBNAILCACHE_H
+#define KISTHUMBNAILCACHE_H
+
+#include "kritaui_export.h"
+#include <QObject>
+#include <QScopedPointer>
+
+class QImage;
+
+/**
+ * A persistent cache of the thumbnails of the documents shown in the
+ * recent documents lists.
+ *
+ * Fetching a thumbnail means opening the document's store, which may be
+ * slow if the file is located on a network share. Therefore the
+ * thumbnails are fetched on a separate thread pool and delivered with
+ * sigThumbnailReady(). The fetched thumbnails are saved as PNG files in
+ * the cache directory of the user. The name of every file is the md5 of
+ * the document's path, its modification time and the requested size, so
+ * the outdated entries are never reused. When the total size of the
+ * cache grows beyond the limit, the least recently used entries are
+ * removed.
+ */
+class KRITAUI_EXPORT KisThumbnailCache : public QObject
+{
+    Q_OBJECT
+public:
+    KisThumbnailCache();
+
+    /**
+     * Creates a cache stored in \p cacheDir, which is trimmed when its
+     * size exceeds \p maxCacheSize bytes. Used in the unit tests.
+     */
+    KisThumbnailCache(const QString &cacheDir, qint64 maxCacheSize);
+
+    ~KisThumbnailCache() override;
+
+    static KisThumbnailCache *instance();
+
+    /**
+     * Schedules fetching the thumbnail of the document at \p url scaled
+     * to fit \p size. When the thumbnail is ready, sigThumbnailReady()
+     * is emitted (with a null image if the document has no thumbnail).
+     */
+    void requestThumbnail(const QString &url, int size);
+
+Q_SIGNALS:
+    void sigThumbnailReady(const QString &url, const QImage &thumbnail);
+
+private:
+    friend class KisThumbnailCacheTest;
+
+    QImage fetchThumbnail(const QString &url, int size);
+    bool saveEntry(const QImage &image, const QString &cachePath);
+    void trimCache();
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISTHUMBNAILCACHE_H
@@ -31,7 +31,7 @@
 #include <QListWidgetItem>
 #include "kis_icon_utils.h"
 #include "krita_utils.h"
-#include "KoStore.h"
+#include "KisThumbnailCache.h"
 
 
 KisWelcomePageWidget::KisWelcomePageWidget(QWidget *parent)
@@ -41,6 +41,11 @@ KisWelcomePageWidget::KisWelcomePageWidget(QWidget *parent)
 
    recentDocumentsListView->viewport()->setAutoFillBackground(false);
    recentDocumentsListView->setSpacing(2);
+
+   recentFilesModel = 0;
+
+   connect(KisThumbnailCache::instance(), SIGNAL(sigThumbnailReady(QString, QImage)),
+           this, SLOT(slotThumbnailReady(QString, QImage)));
 }
 
 KisWelcomePageWidget::~KisWelcomePageWidget()
@@ -173,29 +178,10 @@ void KisWelcomePageWidget::populateRecentDocuments()
        QString fileName = recentFileUrlPath.split("/").last();
 
 
-       // get thumbnail -- almost all Krita-supported formats save a thumbnail
-       // this was mostly copied from the KisAutoSaveRecovery file
-       QScopedPointer<KoStore> store(KoStore::createStore(QUrl(recentFileUrlPath), KoStore::Read));
-
-       if (store) {
-           if (store->open(QString("Thumbnails/thumbnail.png"))
-              || store->open(QString("preview.png"))) {
-
-               QByteArray bytes = store->read(store->size());
-               store->close();
-               QImage img;
-               img.loadFromData(bytes);
-               recentItem->setIcon(QIcon(QPixmap::fromImage(img)));
-
-           }
-           else {
-               recentItem->setIcon(KisIconUtils::loadIcon("document-export"));
-           }
-
-       }
-       else {
-           recentItem->setIcon(KisIconUtils::loadIcon("document-export"));
-       }
+       // the thumbnail is fetched in the background, since opening
+       // the document may take a while if it is on a network share
+       recentItem->setIcon(KisIconUtils::loadIcon("document-export"));
+       KisThumbnailCache::instance()->requestThumbnail(recentFileUrlPath, 128);
 
 
        // set the recent object with the data
@@ -218,6 +204,19 @@ void KisWelcomePageWidget::populateRecentDocuments()
 }
 
 
+void KisWelcomePageWidget::slotThumbnailReady(const QString &url, const QImage &thumbnail)
+{
+    if (!recentFilesModel || thumbnail.isNull()) return;
+
+    for (int i = 0; i < recentFilesModel->rowCount(); i++) {
+        QStandardItem *recentItem = recentFilesModel->item(i);
+
+        if (recentItem->toolTip() == url) {
+            recentItem->setIcon(QIcon(QPixmap::fromImage(thumbnail)));
+        }
+    }
+}
+
 void KisWelcomePageWidget::recentDocumentClicked(QModelIndex index)
 {
     QString fileUrl = index.data(Qt::ToolTipRole).toString();
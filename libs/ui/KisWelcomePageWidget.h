@@ -61,6 +61,7 @@ private Q_SLOTS:
     void slotClearRecentFiles();
 
     void recentDocumentClicked(QModelIndex index);
+    void slotThumbnailReady(const QString &url, const QImage &thumbnail);
 
     /// go to URL links
     void slotGoToManual();
@@ -18,6 +18,7 @@
 #include "kis_image_pyramid.h"
 
 #include <QBitArray>
+#include <QtConcurrent>
 #include <KoChannelInfo.h>
 #include <KoCompositeOp.h>
 #include <KoColorSpaceRegistry.h>
@@ -98,6 +99,45 @@ inline void alignRectBy2(qint32 &x, qint32 &y, qint32 &w, qint32 &h)
 }
 
 
+/**
+ * The planes of the pyramid are processed in stripes of this
+ * height. It is equal to the tile size, so different stripes never
+ * write into the same tile.
+ */
+static const qint32 stripeHeight = 64;
+
+/**
+ * Converts @numPixels from @srcCs into @dstCs in chunks processed
+ * in parallel. The color conversion is the most expensive part of
+ * updating the pyramid, and it is done for every canvas update.
+ */
+static void convertPixelsParallel(const KoColorSpace *srcCs, const quint8 *src,
+                                  const KoColorSpace *dstCs, quint8 *dst,
+                                  quint32 numPixels,
+                                  KoColorConversionTransformation::Intent renderingIntent,
+                                  KoColorConversionTransformation::ConversionFlags conversionFlags)
+{
+    const quint32 chunkSize = stripeHeight * stripeHeight;
+
+    QVector<quint32> chunks;
+    for (quint32 offset = 0; offset < numPixels; offset += chunkSize) {
+        chunks << offset;
+    }
+
+    const quint32 srcPixelSize = srcCs->pixelSize();
+    const quint32 dstPixelSize = dstCs->pixelSize();
+
+    QtConcurrent::blockingMap(chunks,
+        [=] (quint32 &offset) {
+            srcCs->convertPixelsTo(src + offset * srcPixelSize,
+                                   dst + offset * dstPixelSize,
+                                   dstCs,
+                                   qMin(chunkSize, numPixels - offset),
+                                   renderingIntent, conversionFlags);
+        });
+}
+
+
 /************* class KisImagePyramid ********************************/
 
 KisImagePyramid::KisImagePyramid(qint32 pyramidHeight)
@@ -263,14 +303,14 @@ void KisImagePyramid::retrieveImageData(const QRect &rect)
             m_displayFilter->filter(originalBytes.data(), numPixels);
         } else {
             QScopedArrayPointer<quint8> dst(new quint8[floatCs->pixelSize() * numPixels]);
-            projectionCs->convertPixelsTo(originalBytes.data(), dst.data(), floatCs, numPixels, KoColorConversionTransformation::internalRenderingIntent(), KoColorConversionTransformation::internalConversionFlags());
+            convertPixelsParallel(projectionCs, originalBytes.data(), floatCs, dst.data(), numPixels, KoColorConversionTransformation::internalRenderingIntent(), KoColorConversionTransformation::internalConversionFlags());
             m_displayFilter->filter(dst.data(), numPixels);
             originalBytes.swap(dst);
         }
 
         {
             QScopedArrayPointer<quint8> dst(new quint8[modifiedMonitorCs->pixelSize() * numPixels]);
-            floatCs->convertPixelsTo(originalBytes.data(), dst.data(), modifiedMonitorCs, numPixels, KoColorConversionTransformation::internalRenderingIntent(), KoColorConversionTransformation::internalConversionFlags());
+            convertPixelsParallel(floatCs, originalBytes.data(), modifiedMonitorCs, dst.data(), numPixels, KoColorConversionTransformation::internalRenderingIntent(), KoColorConversionTransformation::internalConversionFlags());
             originalBytes.swap(dst);
         }
 #endif
@@ -325,7 +365,7 @@ void KisImagePyramid::retrieveImageData(const QRect &rect)
         }
 
         QScopedArrayPointer<quint8> dst(new quint8[m_monitorColorSpace->pixelSize() * numPixels]);
-        projectionCs->convertPixelsTo(originalBytes.data(), dst.data(), m_monitorColorSpace, numPixels, m_renderingIntent, m_conversionFlags);
+        convertPixelsParallel(projectionCs, originalBytes.data(), m_monitorColorSpace, dst.data(), numPixels, m_renderingIntent, m_conversionFlags);
         originalBytes.swap(dst);
     }
 
@@ -377,6 +417,36 @@ QRect KisImagePyramid::downsampleByFactor2(const QRect& srcRect,
     qint32 dstWidth = srcWidth / 2;
     qint32 dstHeight = srcHeight / 2;
 
+    /**
+     * Image pixels are always positive (see alignSourceRect()), so
+     * the stripes can be aligned to the tile grid with plain division
+     */
+    QVector<QRect> stripes;
+    for (qint32 y = dstY; y < dstY + dstHeight;) {
+        const qint32 nextY = qMin((y / stripeHeight + 1) * stripeHeight, dstY + dstHeight);
+        stripes << QRect(dstX, y, dstWidth, nextY - y);
+        y = nextY;
+    }
+
+    QtConcurrent::blockingMap(stripes,
+        [src, dst] (QRect &dstStripe) {
+            downsampleStripe(dstStripe, src, dst);
+        });
+
+    return QRect(dstX, dstY, dstWidth, dstHeight);
+}
+
+void KisImagePyramid::downsampleStripe(const QRect &dstRect,
+                                       KisPaintDevice* src,
+                                       KisPaintDevice* dst)
+{
+    qint32 dstX, dstY, dstWidth, dstHeight;
+    dstRect.getRect(&dstX, &dstY, &dstWidth, &dstHeight);
+
+    const qint32 srcX = 2 * dstX;
+    const qint32 srcY = 2 * dstY;
+    const qint32 srcWidth = 2 * dstWidth;
+
     KisHLineConstIteratorSP srcIt0 = src->createHLineConstIteratorNG(srcX, srcY, srcWidth);
     KisHLineConstIteratorSP srcIt1 = src->createHLineConstIteratorNG(srcX, srcY + 1, srcWidth);
     KisHLineIteratorSP dstIt = dst->createHLineIteratorNG(dstX, dstY, dstWidth);
@@ -403,7 +473,6 @@ QRect KisImagePyramid::downsampleByFactor2(const QRect& srcRect,
         srcIt1->nextRow();
         dstIt->nextRow();
     }
-    return QRect(dstX, dstY, dstWidth, dstHeight);
 }
 
 void  KisImagePyramid::downsamplePixels(const quint8 *srcRow0,
@@ -412,26 +481,20 @@ void  KisImagePyramid::downsamplePixels(const quint8 *srcRow0,
                                         qint32 numSrcPixels)
 {
     /**
-     * FIXME (mandatory): Use SSE and friends here.
+     * The loop is written channel-wise without any branches, so that
+     * the compiler could vectorize it
      */
 
-    qint16 b = 0;
-    qint16 g = 0;
-    qint16 r = 0;
-    qint16 a = 0;
-
     static const qint32 pixelSize = 4; // This is preview argb8 mode
 
     for (qint32 i = 0; i < numSrcPixels / 2; i++) {
-        b = srcRow0[0] + srcRow1[0] + srcRow0[4] + srcRow1[4];
-        g = srcRow0[1] + srcRow1[1] + srcRow0[5] + srcRow1[5];
-        r = srcRow0[2] + srcRow1[2] + srcRow0[6] + srcRow1[6];
-        a = srcRow0[3] + srcRow1[3] + srcRow0[7] + srcRow1[7];
-
-        dstRow[0] = b / 4;
-        dstRow[1] = g / 4;
-        dstRow[2] = r / 4;
-        dstRow[3] = a / 4;
+        for (qint32 ch = 0; ch < pixelSize; ch++) {
+            const quint16 sum =
+                quint16(srcRow0[ch]) + srcRow1[ch] +
+                srcRow0[ch + pixelSize] + srcRow1[ch + pixelSize];
+
+            dstRow[ch] = sum >> 2;
+        }
 
         dstRow += pixelSize;
         srcRow0 += 2 * pixelSize;
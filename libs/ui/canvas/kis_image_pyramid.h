@@ -87,13 +87,22 @@ private:
     QRect downsampleByFactor2(const QRect& srcRect,
                               KisPaintDevice* src, KisPaintDevice* dst);
 
+    /**
+     * Downsamples the part of @src paint device that corresponds
+     * to @dstRect and writes it into @dst. Different threads may
+     * process different stripes of the same plane, provided the
+     * stripes don't share tiles of @dst
+     */
+    static void downsampleStripe(const QRect &dstRect,
+                                 KisPaintDevice* src, KisPaintDevice* dst);
+
     /**
      * Auxiliary function. Downsamples two lines in @srcRow0
      * and @srcRow1 into one line @dstRow
      * Note: @numSrcPixels must be EVEN
      */
-    void downsamplePixels(const quint8 *srcRow0, const quint8 *srcRow1,
-                          quint8 *dstRow, qint32 numSrcPixels);
+    static void downsamplePixels(const quint8 *srcRow0, const quint8 *srcRow1,
+                                 quint8 *dstRow, qint32 numSrcPixels);
 
     /**
      * Searches for the last pyramid plane that can cover
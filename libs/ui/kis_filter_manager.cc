@@ -47,6 +47,9 @@
 #include "dialogs/kis_dlg_filter.h"
 #include "strokes/kis_filter_stroke_strategy.h"
 #include "krita_utils.h"
+#include "kis_coordinates_converter.h"
+#include <kis_global.h>
+#include <kis_pointer_utils.h>
 
 
 struct KisFilterManager::Private {
@@ -72,8 +75,63 @@ struct KisFilterManager::Private {
     QSignalMapper actionsMapper;
 
     QPointer<KisDlgFilter> filterDialog;
+
+    struct PreviewCacheItem {
+        QString configXML;
+        QRect processRect;
+        KisFilterStrokeStrategy::ResultCacheSP cache;
+    };
+
+    /**
+     * The results of the recent previews, the most recent first. They
+     * make returning to the previous values of the sliders instant.
+     */
+    QList<PreviewCacheItem> previewCache;
+
+    KisFilterStrokeStrategy::ResultCacheSP fetchPreviewCache(const QString &configXML,
+                                                            const QRect &processRect,
+                                                            const KoColorSpace *colorSpace,
+                                                            int numJobs);
 };
 
+namespace {
+const int maxPreviewCacheSize = 3;
+}
+
+KisFilterStrokeStrategy::ResultCacheSP
+KisFilterManager::Private::fetchPreviewCache(const QString &configXML,
+                                             const QRect &processRect,
+                                             const KoColorSpace *colorSpace,
+                                             int numJobs)
+{
+    for (int i = 0; i < previewCache.size(); i++) {
+        const PreviewCacheItem &item = previewCache[i];
+
+        if (item.configXML == configXML && item.processRect == processRect) {
+            if (item.cache->isReady()) {
+                previewCache.move(i, 0);
+                return item.cache;
+            }
+
+            // the stroke that recorded the item has been cancelled
+            previewCache.removeAt(i);
+            break;
+        }
+    }
+
+    PreviewCacheItem item;
+    item.configXML = configXML;
+    item.processRect = processRect;
+    item.cache = toQShared(new KisFilterStrokeStrategy::ResultCache(colorSpace, numJobs));
+
+    previewCache.prepend(item);
+    while (previewCache.size() > maxPreviewCacheSize) {
+        previewCache.removeLast();
+    }
+
+    return item.cache;
+}
+
 KisFilterManager::KisFilterManager(KisViewManager * view)
     : d(new Private)
 {
@@ -277,25 +335,49 @@ void KisFilterManager::apply(KisFilterConfigurationSP filterConfig)
                                  d->view->activeNode(),
                                  resourceManager);
 
-    d->currentStrokeId =
-        image->startStroke(new KisFilterStrokeStrategy(filter,
-                                                       KisFilterConfigurationSP(filterConfig),
-                                                       resources));
+    KisFilterStrokeStrategy *strategy =
+        new KisFilterStrokeStrategy(filter,
+                                    KisFilterConfigurationSP(filterConfig),
+                                    resources);
 
     QRect processRect = filter->changedRect(applyRect, filterConfig.data(), 0);
     processRect &= image->bounds();
 
+    QVector<QRect> rects;
+
     if (filter->supportsThreading()) {
         QSize size = KritaUtils::optimalPatchSize();
-        QVector<QRect> rects = KritaUtils::splitRectIntoPatches(processRect, size);
-
-        Q_FOREACH (const QRect &rc, rects) {
-            image->addJob(d->currentStrokeId,
-                          new KisFilterStrokeStrategy::Data(rc, true));
+        rects = KritaUtils::splitRectIntoPatches(processRect, size);
+
+        /**
+         * The patches are processed roughly in the order they are
+         * added, so start from the ones the user is looking at.
+         */
+        if (d->view->canvasBase()) {
+            const QPointF viewCenter =
+                d->view->canvasBase()->coordinatesConverter()->widgetRectInImagePixels().center();
+
+            std::stable_sort(rects.begin(), rects.end(),
+                [viewCenter] (const QRect &lhs, const QRect &rhs) {
+                    return kisSquareDistance(lhs.center(), viewCenter) <
+                           kisSquareDistance(rhs.center(), viewCenter);
+                });
         }
     } else {
+        rects << processRect;
+    }
+
+    if (paintDevice && d->filterDialog) {
+        strategy->setResultCache(
+            d->fetchPreviewCache(filterConfig->toXML(), processRect,
+                                 paintDevice->colorSpace(), rects.size()));
+    }
+
+    d->currentStrokeId = image->startStroke(strategy);
+
+    Q_FOREACH (const QRect &rc, rects) {
         image->addJob(d->currentStrokeId,
-                      new KisFilterStrokeStrategy::Data(processRect, false));
+                      new KisFilterStrokeStrategy::Data(rc, filter->supportsThreading()));
     }
 
     d->currentlyAppliedConfiguration = filterConfig;
@@ -314,6 +396,7 @@ void KisFilterManager::finish()
     }
 
     d->lastConfiguration = d->currentlyAppliedConfiguration;
+    d->previewCache.clear();
     d->reapplyAction->setEnabled(true);
     d->reapplyAction->setText(i18n("Apply Filter Again: %1", filter->name()));
 
@@ -329,6 +412,7 @@ void KisFilterManager::cancel()
 
     d->currentStrokeId.clear();
     d->currentlyAppliedConfiguration.clear();
+    d->previewCache.clear();
 }
 
 bool KisFilterManager::isStrokeRunning() const
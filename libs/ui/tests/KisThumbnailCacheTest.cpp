@@ -0,0 +1,88 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "KisThumbnailCacheTest.h"
+
+#include <QTest>
+#include <QTemporaryDir>
+#include <QFileInfo>
+#include <QImage>
+#include <limits>
+
+#include "KisThumbnailCache.h"
+
+
+void KisThumbnailCacheTest::testTrimCache()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    QImage image(64, 64, QImage::Format_ARGB32);
+    for (int y = 0; y < image.height(); y++) {
+        for (int x = 0; x < image.width(); x++) {
+            image.setPixel(x, y, qRgba(x * 4, y * 4, (x * y) & 0xff, 255));
+        }
+    }
+
+    const QStringList names = QStringList() << "a" << "b" << "c" << "d";
+
+    auto entryPath = [&dir] (const QString &name) {
+        return dir.path() + "/" + name + ".png";
+    };
+
+    {
+        KisThumbnailCache cache(dir.path(), std::numeric_limits<qint64>::max());
+
+        /**
+         * Some file systems store the modification time with a
+         * precision of one second, so wait for a bit more between the
+         * entries to make their order well-defined
+         */
+        Q_FOREACH (const QString &name, names) {
+            QVERIFY(cache.saveEntry(image, entryPath(name)));
+            QTest::qSleep(1100);
+        }
+
+        // refreshing the oldest entry makes it the most recently used one
+        QVERIFY(cache.saveEntry(image, entryPath("a")));
+    }
+
+    const qint64 entrySize = QFileInfo(entryPath("a")).size();
+    QVERIFY(entrySize > 0);
+
+    Q_FOREACH (const QString &name, names) {
+        QCOMPARE(QFileInfo(entryPath(name)).size(), entrySize);
+    }
+
+    // the cache of 3.5 entries is trimmed down to 2.625 entries
+    KisThumbnailCache cache(dir.path(), entrySize * 7 / 2);
+    cache.trimCache();
+
+    QVERIFY(QFileInfo(entryPath("a")).exists());
+    QVERIFY(!QFileInfo(entryPath("b")).exists());
+    QVERIFY(!QFileInfo(entryPath("c")).exists());
+    QVERIFY(QFileInfo(entryPath("d")).exists());
+
+    // the cache fitting into the limit is not touched
+    cache.trimCache();
+
+    QVERIFY(QFileInfo(entryPath("a")).exists());
+    QVERIFY(QFileInfo(entryPath("d")).exists());
+}
+
+QTEST_MAIN(KisThumbnailCacheTest)
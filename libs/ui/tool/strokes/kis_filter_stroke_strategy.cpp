@@ -21,6 +21,7 @@
 #include <filter/kis_filter.h>
 #include <filter/kis_filter_configuration.h>
 #include <kis_transaction.h>
+#include <kis_paint_device.h>
 #include <KoCompositeOpRegistry.h>
 
 
@@ -29,7 +30,8 @@ struct KisFilterStrokeStrategy::Private {
         : updatesFacade(0),
           cancelSilently(false),
           secondaryTransaction(0),
-          levelOfDetail(0)
+          levelOfDetail(0),
+          reuseResultCache(false)
     {
     }
 
@@ -43,7 +45,8 @@ struct KisFilterStrokeStrategy::Private {
           filterDeviceBounds(),
           secondaryTransaction(0),
           progressHelper(),
-          levelOfDetail(0)
+          levelOfDetail(0),
+          reuseResultCache(false)
     {
         KIS_ASSERT_RECOVER_RETURN(!rhs.filterDevice);
         KIS_ASSERT_RECOVER_RETURN(rhs.filterDeviceBounds.isEmpty());
@@ -64,8 +67,17 @@ struct KisFilterStrokeStrategy::Private {
     QScopedPointer<KisProcessingVisitor::ProgressHelper> progressHelper;
 
     int levelOfDetail;
+
+    KisFilterStrokeStrategy::ResultCacheSP resultCache;
+    bool reuseResultCache;
 };
 
+KisFilterStrokeStrategy::ResultCache::ResultCache(const KoColorSpace *colorSpace, int numJobs)
+    : device(new KisPaintDevice(colorSpace)),
+      numPendingJobs(numJobs)
+{
+}
+
 
 KisFilterStrokeStrategy::KisFilterStrokeStrategy(KisFilterSP filter,
                                                  KisFilterConfigurationSP filterConfig,
@@ -136,9 +148,16 @@ void KisFilterStrokeStrategy::doStrokeCallback(KisStrokeJobData *data)
     if (d) {
         const QRect rc = d->processRect;
 
+        if (m_d->reuseResultCache) {
+            KisPainter::copyAreaOptimized(rc.topLeft(), m_d->resultCache->device, targetDevice(), rc);
+            m_d->node->setDirty(rc);
+            return;
+        }
+
         if (!m_d->filterDeviceBounds.intersects(
                 m_d->filter->neededRect(rc, m_d->filterConfig.data(), m_d->levelOfDetail))) {
 
+            recordResult(rc);
             return;
         }
 
@@ -153,6 +172,7 @@ void KisFilterStrokeStrategy::doStrokeCallback(KisStrokeJobData *data)
             m_d->filterDevice->clear(rc);
         }
 
+        recordResult(rc);
         m_d->node->setDirty(rc);
     } else if (cancelJob) {
         m_d->cancelSilently = true;
@@ -201,8 +221,27 @@ void KisFilterStrokeStrategy::finishStrokeCallback()
 
 KisStrokeStrategy* KisFilterStrokeStrategy::createLodClone(int levelOfDetail)
 {
+    // copying the cached result is cheaper than any preview
+    if (m_d->reuseResultCache) return 0;
+
     if (!m_d->filter->supportsLevelOfDetail(m_d->filterConfig.data(), levelOfDetail)) return 0;
 
     KisFilterStrokeStrategy *clone = new KisFilterStrokeStrategy(*this, levelOfDetail);
     return clone;
 }
+
+void KisFilterStrokeStrategy::setResultCache(ResultCacheSP cache)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(!m_d->levelOfDetail);
+
+    m_d->resultCache = cache;
+    m_d->reuseResultCache = cache->isReady();
+}
+
+void KisFilterStrokeStrategy::recordResult(const QRect &rc)
+{
+    if (!m_d->resultCache || m_d->reuseResultCache) return;
+
+    KisPainter::copyAreaOptimized(rc.topLeft(), targetDevice(), m_d->resultCache->device, rc);
+    m_d->resultCache->numPendingJobs.deref();
+}
@@ -19,10 +19,15 @@
 #ifndef __KIS_FILTER_STROKE_STRATEGY_H
 #define __KIS_FILTER_STROKE_STRATEGY_H
 
+#include <QAtomicInt>
+#include <QSharedPointer>
+
 #include "kis_types.h"
 #include "kis_painter_based_stroke_strategy.h"
 #include "kis_lod_transform.h"
 
+class KoColorSpace;
+
 
 class KRITAUI_EXPORT KisFilterStrokeStrategy : public KisPainterBasedStrokeStrategy
 {
@@ -60,6 +65,26 @@ public:
         }
     };
 
+    /**
+     * Keeps the result of a filter stroke, so that it could be reused
+     * by a later stroke with the same configuration without running
+     * the filter again. The cache is ready when all \p numJobs jobs of
+     * the stroke that recorded it have been processed.
+     */
+    class ResultCache {
+    public:
+        ResultCache(const KoColorSpace *colorSpace, int numJobs);
+
+        bool isReady() const {
+            return !numPendingJobs.load();
+        }
+
+        KisPaintDeviceSP device;
+        QAtomicInt numPendingJobs;
+    };
+
+    typedef QSharedPointer<ResultCache> ResultCacheSP;
+
 public:
     KisFilterStrokeStrategy(KisFilterSP filter,
                             KisFilterConfigurationSP filterConfig,
@@ -76,6 +101,17 @@ public:
 
     KisStrokeStrategy* createLodClone(int levelOfDetail) override;
 
+    /**
+     * If \p cache is ready, the stroke copies the pixels from it
+     * instead of running the filter. Otherwise the stroke records its
+     * result into the cache. Only the stroke at the level of detail 0
+     * uses the cache.
+     */
+    void setResultCache(ResultCacheSP cache);
+
+private:
+    void recordResult(const QRect &rc);
+
 private:
     struct Private;
     Private* const m_d;
@@ -27,12 +27,63 @@
 
 #include "KoChannelInfo.h"
 #include "kis_paint_device.h"
+#include "kis_painter.h"
 #include "KoColorSpace.h"
 #include "kis_iterator_ng.h"
 #include "kis_canvas2.h"
 
+HistogramCellCache::HistogramCellCache(const KoColorSpace *_colorSpace, const QRect &_bounds)
+    : colorSpace(_colorSpace),
+      bounds(_bounds)
+{
+    cellsPerRow = (bounds.width() + cellSize - 1) / cellSize;
+    cellsPerColumn = (bounds.height() + cellSize - 1) / cellSize;
+
+    const quint32 imageSize = bounds.width() * bounds.height();
+    nSkip = 1 + (imageSize >> 20); //for speed use about 1M pixels for computing histograms
+
+    cells.resize(cellsPerRow * cellsPerColumn);
+
+    total.resize(colorSpace->channelCount());
+    for (auto &bin : total) {
+        bin.resize(std::numeric_limits<quint8>::max() + 1);
+    }
+}
+
+QRect HistogramCellCache::cellRect(int index) const
+{
+    const int col = index % cellsPerRow;
+    const int row = index / cellsPerRow;
+
+    return QRect(bounds.x() + col * cellSize,
+                 bounds.y() + row * cellSize,
+                 cellSize, cellSize) & bounds;
+}
+
+QVector<int> HistogramCellCache::cellsInRect(const QRect &rc) const
+{
+    QVector<int> result;
+
+    const QRect rect = rc & bounds;
+    if (rect.isEmpty()) return result;
+
+    const int firstCol = (rect.left() - bounds.x()) / cellSize;
+    const int lastCol = (rect.right() - bounds.x()) / cellSize;
+    const int firstRow = (rect.top() - bounds.y()) / cellSize;
+    const int lastRow = (rect.bottom() - bounds.y()) / cellSize;
+
+    for (int row = firstRow; row <= lastRow; row++) {
+        for (int col = firstCol; col <= lastCol; col++) {
+            result.append(row * cellsPerRow + col);
+        }
+    }
+
+    return result;
+}
+
 HistogramDockerWidget::HistogramDockerWidget(QWidget *parent, const char *name, Qt::WindowFlags f)
-    : QLabel(parent, f), m_paintDevice(nullptr), m_smoothHistogram(true)
+    : QLabel(parent, f), m_paintDevice(nullptr), m_smoothHistogram(true),
+      m_computationInProgress(false), m_updateRequested(false)
 {
     setObjectName(name);
 }
@@ -52,18 +103,94 @@ void HistogramDockerWidget::setPaintDevice(KisCanvas2* canvas)
         m_bounds = QRect();
         m_histogramData.clear();
     }
+
+    m_cellCache.clear();
+    m_dirtyCells.clear();
+}
+
+void HistogramDockerWidget::resetCellCache()
+{
+    m_cellCache.reset(new HistogramCellCache(m_paintDevice->colorSpace(), m_bounds));
+    m_dirtyCells.clear();
+
+    for (int i = 0; i < m_cellCache->numCells(); i++) {
+        m_dirtyCells.insert(i);
+    }
+}
+
+void HistogramDockerWidget::addDirtyRect(const QRect &rc)
+{
+    // the cells of a not yet existing cache are all dirty anyway
+    if (!m_cellCache) return;
+
+    Q_FOREACH (int index, m_cellCache->cellsInRect(rc)) {
+        m_dirtyCells.insert(index);
+    }
 }
 
 void HistogramDockerWidget::updateHistogram()
 {
     if (!m_paintDevice.isNull()) {
+        /**
+         * The cache is shared with the worker thread, so we should never
+         * have two computations running at the same time. The update
+         * will be restarted as soon as the current one is finished.
+         */
+        if (m_computationInProgress) {
+            m_updateRequested = true;
+            return;
+        }
+
+        if (!m_cellCache ||
+            m_cellCache->colorSpace != m_paintDevice->colorSpace() ||
+            m_cellCache->bounds != m_bounds) {
+
+            resetCellCache();
+        }
+
+        /**
+         * The cells are clipped by the exact bounds of the device, so when
+         * the bounds change, the cells whose clipped part has changed
+         * should be recalculated, even if their pixels have not.
+         */
+        const QRect exactBounds = m_paintDevice->exactBounds() & m_bounds;
+
+        if (exactBounds != m_cellCache->exactBounds) {
+            const QRect oldExactBounds = m_cellCache->exactBounds;
+
+            Q_FOREACH (int index, m_cellCache->cellsInRect(exactBounds | oldExactBounds)) {
+                const QRect rc = m_cellCache->cellRect(index);
+                if ((rc & exactBounds) != (rc & oldExactBounds)) {
+                    m_dirtyCells.insert(index);
+                }
+            }
+
+            m_cellCache->exactBounds = exactBounds;
+        }
+
+        if (m_dirtyCells.isEmpty()) return;
+
+        QVector<int> dirtyCells;
+        dirtyCells.reserve(m_dirtyCells.size());
+        Q_FOREACH (int index, m_dirtyCells) {
+            dirtyCells.append(index);
+        }
+        m_dirtyCells.clear();
+
+        // the worker needs only the dirty cells, the rest is cached
         KisPaintDeviceSP m_devClone = new KisPaintDevice(m_paintDevice->colorSpace());
 
-        m_devClone->makeCloneFrom(m_paintDevice, m_bounds);
+        Q_FOREACH (int index, dirtyCells) {
+            const QRect rc = m_cellCache->cellRect(index) & exactBounds;
+            if (!rc.isEmpty()) {
+                KisPainter::copyAreaOptimized(rc.topLeft(), m_paintDevice, m_devClone, rc);
+            }
+        }
 
-        HistogramComputationThread *workerThread = new HistogramComputationThread(m_devClone, m_bounds);
+        HistogramComputationThread *workerThread = new HistogramComputationThread(m_devClone, m_cellCache, dirtyCells);
         connect(workerThread, &HistogramComputationThread::resultReady, this, &HistogramDockerWidget::receiveNewHistogram);
         connect(workerThread, &HistogramComputationThread::finished, workerThread, &QObject::deleteLater);
+        m_computationInProgress = true;
         workerThread->start();
     } else {
         m_histogramData.clear();
@@ -73,8 +200,18 @@ void HistogramDockerWidget::updateHistogram()
 
 void HistogramDockerWidget::receiveNewHistogram(HistVector *histogramData)
 {
-    m_histogramData = *histogramData;
-    update();
+    m_computationInProgress = false;
+
+    // the result of a cache that has already been reset is outdated
+    if (m_cellCache && histogramData == &m_cellCache->total) {
+        m_histogramData = *histogramData;
+        update();
+    }
+
+    if (m_updateRequested) {
+        m_updateRequested = false;
+        updateHistogram();
+    }
 }
 
 void HistogramDockerWidget::paintEvent(QPaintEvent *event)
@@ -160,38 +297,55 @@ void HistogramComputationThread::run()
     quint32 channelCount = m_dev->channelCount();
     quint32 pixelSize = m_dev->pixelSize();
 
-    quint32 imageSize = m_bounds.width() * m_bounds.height();
-    quint32 nSkip = 1 + (imageSize >> 20); //for speed use about 1M pixels for computing histograms
+    const quint32 nSkip = m_cache->nSkip;
+    const QRect exactBounds = m_cache->exactBounds;
 
-    //allocate space for the histogram data
-    bins.resize((int)channelCount);
-    for (auto &bin : bins) {
-        bin.resize(std::numeric_limits<quint8>::max() + 1);
-    }
+    HistVector &total = m_cache->total;
+
+    Q_FOREACH (int index, m_dirtyCells) {
+        HistVector &bins = m_cache->cells[index];
+
+        // remove the outdated contribution of the cell
+        for (int chan = 0; chan < (int)bins.size(); ++chan) {
+            for (int i = 0; i < (int)bins[chan].size(); ++i) {
+                total[chan][i] -= bins[chan][i];
+            }
+        }
+
+        bins.resize((int)channelCount);
+        for (auto &bin : bins) {
+            bin.assign(std::numeric_limits<quint8>::max() + 1, 0);
+        }
 
-    QRect bounds = m_dev->exactBounds();
-    if (bounds.isEmpty())
-        return;
+        const QRect rc = m_cache->cellRect(index) & exactBounds;
+        if (rc.isEmpty()) continue;
 
-    quint32 toSkip = nSkip;
+        quint32 toSkip = nSkip;
 
-    KisSequentialConstIterator it(m_dev, m_dev->exactBounds());
+        KisSequentialConstIterator it(m_dev, rc);
 
-    int numConseqPixels = it.nConseqPixels();
-    while (it.nextPixels(numConseqPixels)) {
+        int numConseqPixels = it.nConseqPixels();
+        while (it.nextPixels(numConseqPixels)) {
 
-        numConseqPixels = it.nConseqPixels();
-        const quint8* pixel = it.rawDataConst();
-        for (int k = 0; k < numConseqPixels; ++k) {
-            if (--toSkip == 0) {
-                for (int chan = 0; chan < (int)channelCount; ++chan) {
-                    bins[chan][cs->scaleToU8(pixel, chan)]++;
+            numConseqPixels = it.nConseqPixels();
+            const quint8* pixel = it.rawDataConst();
+            for (int k = 0; k < numConseqPixels; ++k) {
+                if (--toSkip == 0) {
+                    for (int chan = 0; chan < (int)channelCount; ++chan) {
+                        bins[chan][cs->scaleToU8(pixel, chan)]++;
+                    }
+                    toSkip = nSkip;
                 }
-                toSkip = nSkip;
+                pixel += pixelSize;
+            }
+        }
+
+        for (int chan = 0; chan < (int)channelCount; ++chan) {
+            for (int i = 0; i < (int)bins[chan].size(); ++i) {
+                total[chan][i] += bins[chan][i];
             }
-            pixel += pixelSize;
         }
     }
 
-    emit resultReady(&bins);
+    emit resultReady(&total);
 }
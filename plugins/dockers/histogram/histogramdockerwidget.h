@@ -23,19 +23,56 @@
 #include <QWidget>
 #include <QLabel>
 #include <QThread>
+#include <QSet>
+#include <QSharedPointer>
 #include "kis_types.h"
 #include <vector>
 
 class KisCanvas2;
+class KoColorSpace;
 
 typedef std::vector<std::vector<quint32> > HistVector; //Don't use QVector here - it's too slow for this purpose
 
 
+/**
+ * The image is split into square cells and the histogram of every cell
+ * is stored separately. The resulting histogram is just a sum of all the
+ * cells, so when some area of the image changes, only the cells covering
+ * it should be recalculated.
+ */
+struct HistogramCellCache
+{
+    static const int cellSize = 256;
+
+    HistogramCellCache(const KoColorSpace *_colorSpace, const QRect &_bounds);
+
+    int numCells() const {
+        return int(cells.size());
+    }
+
+    QRect cellRect(int index) const;
+    QVector<int> cellsInRect(const QRect &rc) const;
+
+    const KoColorSpace *colorSpace;
+    QRect bounds;
+    QRect exactBounds; ///< only the pixels inside the exact bounds are counted
+    int cellsPerRow;
+    int cellsPerColumn;
+    quint32 nSkip;
+
+    std::vector<HistVector> cells;
+    HistVector total;
+};
+
+typedef QSharedPointer<HistogramCellCache> HistogramCellCacheSP;
+
+
 class HistogramComputationThread : public QThread
 {
     Q_OBJECT
 public:
-    HistogramComputationThread(KisPaintDeviceSP _dev, const QRect& _bounds) : m_dev(_dev), m_bounds(_bounds)
+    HistogramComputationThread(KisPaintDeviceSP _dev, HistogramCellCacheSP _cache, const QVector<int> &_dirtyCells)
+        : m_dev(_dev), m_cache(_cache), m_dirtyCells(_dirtyCells)
     {}
 
     void run() override;
@@ -45,8 +82,8 @@ Q_SIGNALS:
 
 private:
     KisPaintDeviceSP m_dev;
-    QRect m_bounds;
-    HistVector bins;
+    HistogramCellCacheSP m_cache;
+    QVector<int> m_dirtyCells;
 };
 
 
@@ -62,13 +99,22 @@ public:
 
 public Q_SLOTS:
     void updateHistogram();
+    void addDirtyRect(const QRect &rc);
     void receiveNewHistogram(HistVector*);
 
+private:
+    void resetCellCache();
+
 private:
     KisPaintDeviceSP m_paintDevice;
     HistVector m_histogramData;
     QRect m_bounds;
     bool m_smoothHistogram;
+
+    HistogramCellCacheSP m_cellCache;
+    QSet<int> m_dirtyCells;
+    bool m_computationInProgress;
+    bool m_updateRequested;
 };
 
 #endif // HISTOGRAMDOCKERWIDGET_H
@@ -19,6 +19,7 @@
 #include <stdlib.h>
 
 #include <QString>
+#include <QTextStream>
 #include <QCommandLineParser>
 #include <QCommandLineOption>
 
@@ -28,6 +29,41 @@
 #include "PythonPluginManager.h"
 #include <opengl/kis_opengl.h>
 
+/**
+ * Calls @p function from the @p script module, passing the list of
+ * @p arguments as the only parameter. Returns false if the call failed.
+ */
+static bool runScript(PyKrita::Python &py, const QString &script, const QString &function, const QStringList &arguments)
+{
+    const QByteArray moduleName = script.toUtf8();
+    const QByteArray functionName = function.toUtf8();
+
+    // functionCall() releases the arguments only when it gets to the
+    // call itself, so resolve the function before building them
+    PyObject* const func = py.itemString(functionName.constData(), moduleName.constData());
+    if (!func || !PyCallable_Check(func)) {
+        qWarning() << "Cannot call" << function << "from" << script;
+        return false;
+    }
+
+    PyObject *argsList = PyList_New(0);
+    Q_FOREACH(const QString arg, arguments) {
+        PyObject* const u = py.unicode(arg);
+        PyList_Append(argsList, u);
+        Py_DECREF(u);
+    }
+
+    // the tuple steals argsList, and functionCall() steals the tuple
+    PyObject *args = PyTuple_New(1);
+    PyTuple_SetItem(args, 0, argsList);
+
+    PyObject *result = py.functionCall(functionName.constData(), moduleName.constData(), args);
+    const bool success = result;
+    Py_XDECREF(result);
+
+    return success;
+}
+
 extern "C" int main(int argc, char **argv)
 {
     // The global initialization of the random generator
@@ -44,7 +80,8 @@ extern "C" int main(int argc, char **argv)
     app.setOrganizationDomain("krita.org");
 
     QCommandLineParser parser;
-    parser.setApplicationDescription("kritarunner executes one python script and then returns.");
+    parser.setApplicationDescription("kritarunner executes one python script and then returns, "
+                                     "or, in batch mode, executes the scripts read from the standard input.");
     parser.addVersionOption();
     parser.addHelpOption();
 
@@ -55,16 +92,27 @@ extern "C" int main(int argc, char **argv)
                                       "The function to call (by default __main__ is called).", "function", "__main__");
     parser.addOption(functionOption);
 
+    QCommandLineOption batchOption(QStringList() << "b" << "batch",
+                                   "Read jobs from the standard input, one per line, and run them all in this process. "
+                                   "Each line consists of the script, the function and the arguments, separated by tabs, "
+                                   "so the arguments may contain spaces, e.g. file names. "
+                                   "For every job a line starting with OK or FAILED is written to the standard output.");
+    parser.addOption(batchOption);
+
     parser.addPositionalArgument("[argument(s)]", "The argumetns for the script");
     parser.process(app);
 
-    if (!parser.isSet(scriptOption)) {
+    const bool batchMode = parser.isSet(batchOption);
+
+    if (!batchMode && !parser.isSet(scriptOption)) {
         qDebug("No script given, aborting.");
         return 1;
     }
 
-    qDebug() << "running:" << parser.value(scriptOption) << parser.value(functionOption);
-    qDebug() << parser.positionalArguments();
+    if (!batchMode) {
+        qDebug() << "running:" << parser.value(scriptOption) << parser.value(functionOption);
+        qDebug() << parser.positionalArguments();
+    }
 
     KoHashGeneratorProvider::instance()->setGenerator("MD5", new KisMD5Generator());
     app.addResourceTypes();
@@ -108,21 +156,41 @@ extern "C" int main(int argc, char **argv)
         return 1;
     }
 
-    PyObject *argsList = PyList_New(0);
-    Q_FOREACH(const QString arg, parser.positionalArguments()) {
-        PyObject* const u = py.unicode(arg);
-        PyList_Append(argsList, u);
-        Py_DECREF(u);
+    if (batchMode) {
+        /**
+         * The application, the resources and the python modules are
+         * initialized only once, so running many short jobs in one
+         * process is much cheaper than starting kritarunner for each
+         * of them.
+         */
+        QTextStream input(stdin);
+        QTextStream output(stdout);
+
+        QString line;
+        while (!(line = input.readLine()).isNull()) {
+            if (line.trimmed().isEmpty()) continue;
+
+            // the fields are tab-separated, the file names may contain spaces
+            QStringList job = line.split('\t');
+            if (job.size() < 2 || job[0].isEmpty() || job[1].isEmpty()) {
+                output << "FAILED " << line << endl;
+                continue;
+            }
+
+            const QString script = job.takeFirst();
+            const QString function = job.takeFirst();
+
+            const bool result = runScript(py, script, function, job);
+
+            // let the documents closed by the script go before the next job
+            QCoreApplication::sendPostedEvents(0, QEvent::DeferredDelete);
+
+            output << (result ? "OK " : "FAILED ") << line << endl;
+        }
+    } else {
+        runScript(py, parser.value(scriptOption), parser.value(functionOption), parser.positionalArguments());
     }
 
-    PyObject *args = PyTuple_New(1);
-    PyTuple_SetItem(args, 0, argsList);
-
-    py.functionCall(parser.value(functionOption).toUtf8().constData(), parser.value(scriptOption).toUtf8().constData(), args);
-
-    Py_DECREF(argsList);
-    Py_DECREF(args);
-
     app.quit();
     return 0;
 }
@@ -23,6 +23,8 @@
 #include "kis_wdg_lens_blur.h"
 
 #include <KoCompositeOp.h>
+#include <KoColorSpace.h>
+#include <KoChannelInfo.h>
 
 #include <kis_convolution_kernel.h>
 #include <kis_convolution_painter.h>
@@ -34,12 +36,284 @@
 #include <kis_selection.h>
 #include <kis_paint_device.h>
 #include <kis_processing_information.h>
+#include <kis_sequential_iterator.h>
+#include <kis_global.h>
 #include "kis_lod_transform.h"
 
 
 #include <QPainter>
+#include <QtMath>
+
+#include <KoUpdater.h>
 
 #include <math.h>
+#include <complex>
+#include <iterator>
+
+namespace {
+
+/**
+ * A component of the circular bokeh kernel:
+ *
+ * exp(-a x^2) * (A cos(b x^2) + B sin(b x^2))
+ *
+ * It is the real combination of a complex Gaussian, which is
+ * separable, so the whole component can be applied as a pair of
+ * complex 1D passes. The sums of the components are the published
+ * fits of a disc with 1-4 components.
+ */
+struct ComplexGaussian {
+    qreal a;
+    qreal b;
+    qreal A;
+    qreal B;
+};
+
+const ComplexGaussian draftComponents[] = {
+    {0.862325, 1.624835, 0.767583, 1.862321}
+};
+
+const ComplexGaussian normalComponents[] = {
+    {0.886528, 5.268909, 0.411259, -0.548794},
+    {1.960518, 1.558213, 0.513282, 4.561110}
+};
+
+const ComplexGaussian highComponents[] = {
+    {2.176490, 5.043495, 1.621035, -2.105439},
+    {1.019306, 9.027613, -0.280860, -0.162882},
+    {2.815110, 1.597273, -0.366471, 10.300301}
+};
+
+const ComplexGaussian bestComponents[] = {
+    {4.338459, 1.553635, -5.767909, 46.164397},
+    {3.839993, 4.693183, 9.795391, -15.227561},
+    {2.791880, 8.178137, -3.048324, 0.302959},
+    {1.342190, 12.328289, 0.010001, 0.244650}
+};
+
+// the fitted discs fall to a half at this point...
+const qreal fittedDiscEdge = 1.1;
+// ...and are negligible after this one
+const qreal fittedKernelEnd = 1.2;
+
+QVector<ComplexGaussian> componentsForQuality(int quality)
+{
+    switch (qBound(1, quality, 4)) {
+    case 1:
+        return QVector<ComplexGaussian>(std::begin(draftComponents), std::end(draftComponents));
+    case 2:
+        return QVector<ComplexGaussian>(std::begin(normalComponents), std::end(normalComponents));
+    case 3:
+        return QVector<ComplexGaussian>(std::begin(highComponents), std::end(highComponents));
+    default:
+        return QVector<ComplexGaussian>(std::begin(bestComponents), std::end(bestComponents));
+    }
+}
+
+int circleKernelRadius(int irisRadius)
+{
+    return qCeil(irisRadius * fittedKernelEnd / fittedDiscEdge);
+}
+
+/**
+ * Applies the circular bokeh to \p rect as a sum of separable complex
+ * components. The cost is linear in the radius instead of quadratic.
+ * The channels are blurred premultiplied by alpha, like in
+ * KisConvolutionPainter, and the pixels outside the bounds of the
+ * image are repeated from its edges.
+ */
+void applyCircleBlur(KisPaintDeviceSP device, const QRect &rect,
+                     int irisRadius, int quality,
+                     const QBitArray &channelFlags,
+                     KoUpdater *progressUpdater)
+{
+    const QVector<ComplexGaussian> components = componentsForQuality(quality);
+    const int radius = circleKernelRadius(irisRadius);
+    const int kernelSize = 2 * radius + 1;
+
+    const KoColorSpace *cs = device->colorSpace();
+    const int pixelSize = cs->pixelSize();
+    const int numChannels = cs->channelCount();
+
+    int alphaIndex = -1;
+    const QList<KoChannelInfo*> channels = cs->channels();
+    for (int i = 0; i < channels.size(); i++) {
+        if (channels[i]->channelType() == KoChannelInfo::ALPHA) {
+            alphaIndex = i;
+        }
+    }
+
+    const QRect srcRect = kisGrowRect(rect, radius);
+    QRect readRect = srcRect & device->defaultBounds()->bounds();
+    if (readRect.isEmpty()) {
+        readRect = srcRect;
+    }
+
+    /**
+     * Read the source as premultiplied planes. The neighbouring patches
+     * may have already been blurred in-place, so the old data is used.
+     */
+    const int readWidth = readRect.width();
+    const int numReadPixels = readWidth * readRect.height();
+
+    QVector<QVector<float>> planes(numChannels, QVector<float>(numReadPixels));
+    {
+        KisSequentialConstIterator srcIt(device, readRect);
+        QVector<float> pixel(numChannels);
+        int i = 0;
+
+        int numConseqPixels = srcIt.nConseqPixels();
+        while (srcIt.nextPixels(numConseqPixels)) {
+            numConseqPixels = srcIt.nConseqPixels();
+
+            const quint8 *srcPtr = srcIt.oldRawData();
+            for (int j = 0; j < numConseqPixels; j++, i++) {
+                cs->normalisedChannelsValue(srcPtr + j * pixelSize, pixel);
+                const float alpha = alphaIndex >= 0 ? pixel[alphaIndex] : 1.0f;
+
+                for (int c = 0; c < numChannels; c++) {
+                    planes[c][i] = c == alphaIndex ? alpha : pixel[c] * alpha;
+                }
+            }
+        }
+    }
+
+    const int width = rect.width();
+    const int height = rect.height();
+    const int srcHeight = srcRect.height();
+
+    QVector<QVector<float>> result(numChannels, QVector<float>(width * height, 0.0f));
+
+    QVector<float> kernelRe(kernelSize);
+    QVector<float> kernelIm(kernelSize);
+
+    QVector<float> paddedRow(srcRect.width());
+    QVector<float> rowRe(width * srcHeight);
+    QVector<float> rowIm(width * srcHeight);
+    QVector<float> accRe(width);
+    QVector<float> accIm(width);
+
+    qreal totalWeight = 0.0;
+
+    const int numSteps = components.size() * numChannels;
+    int step = 0;
+
+    Q_FOREACH (const ComplexGaussian &g, components) {
+        std::complex<qreal> kernelSum;
+
+        for (int t = -radius; t <= radius; t++) {
+            const qreal x = t * fittedDiscEdge / irisRadius;
+            const std::complex<qreal> value =
+                std::exp(-g.a * x * x) * std::polar(1.0, g.b * x * x);
+
+            kernelRe[t + radius] = value.real();
+            kernelIm[t + radius] = value.imag();
+            kernelSum += value;
+        }
+
+        const std::complex<qreal> weight2D = kernelSum * kernelSum;
+        totalWeight += g.A * weight2D.real() + g.B * weight2D.imag();
+
+        for (int c = 0; c < numChannels; c++) {
+            if (!channelFlags.testBit(c) && c != alphaIndex) {
+                step++;
+                continue;
+            }
+
+            const QVector<float> &plane = planes[c];
+
+            // horizontal pass, the source is real
+            for (int y = 0; y < srcHeight; y++) {
+                const int readY = qBound(readRect.top(), srcRect.top() + y, readRect.bottom()) - readRect.top();
+                const float *readRow = plane.constData() + readY * readWidth;
+
+                for (int x = 0; x < paddedRow.size(); x++) {
+                    const int readX = qBound(readRect.left(), srcRect.left() + x, readRect.right()) - readRect.left();
+                    paddedRow[x] = readRow[readX];
+                }
+
+                float *re = rowRe.data() + y * width;
+                float *im = rowIm.data() + y * width;
+                std::fill(re, re + width, 0.0f);
+                std::fill(im, im + width, 0.0f);
+
+                for (int t = 0; t < kernelSize; t++) {
+                    const float kRe = kernelRe[t];
+                    const float kIm = kernelIm[t];
+                    const float *src = paddedRow.constData() + t;
+
+                    for (int x = 0; x < width; x++) {
+                        re[x] += src[x] * kRe;
+                        im[x] += src[x] * kIm;
+                    }
+                }
+            }
+
+            // vertical pass, complex by complex
+            float *dst = result[c].data();
+            const float A = g.A;
+            const float B = g.B;
+
+            for (int y = 0; y < height; y++) {
+                std::fill(accRe.begin(), accRe.end(), 0.0f);
+                std::fill(accIm.begin(), accIm.end(), 0.0f);
+
+                for (int t = 0; t < kernelSize; t++) {
+                    const float kRe = kernelRe[t];
+                    const float kIm = kernelIm[t];
+                    const float *re = rowRe.constData() + (y + t) * width;
+                    const float *im = rowIm.constData() + (y + t) * width;
+
+                    for (int x = 0; x < width; x++) {
+                        accRe[x] += re[x] * kRe - im[x] * kIm;
+                        accIm[x] += re[x] * kIm + im[x] * kRe;
+                    }
+                }
+
+                float *dstRow = dst + y * width;
+                for (int x = 0; x < width; x++) {
+                    dstRow[x] += A * accRe[x] + B * accIm[x];
+                }
+            }
+
+            if (progressUpdater) {
+                progressUpdater->setProgress(100 * ++step / numSteps);
+            }
+        }
+    }
+
+    // write the blurred channels back
+    QVector<quint8> bytes(width * height * pixelSize);
+    device->readBytes(bytes.data(), rect);
+
+    const float normalization = 1.0 / totalWeight;
+    QVector<float> pixel(numChannels);
+
+    for (int i = 0; i < width * height; i++) {
+        quint8 *dstPixel = bytes.data() + i * pixelSize;
+        cs->normalisedChannelsValue(dstPixel, pixel);
+
+        const float alpha = alphaIndex >= 0 ?
+            qBound(0.0f, result[alphaIndex][i] * normalization, 1.0f) : 1.0f;
+
+        for (int c = 0; c < numChannels; c++) {
+            if (!channelFlags.testBit(c)) continue;
+
+            if (c == alphaIndex) {
+                pixel[c] = alpha;
+            } else {
+                pixel[c] = alpha > 0.0f ?
+                    qMax(0.0f, result[c][i] * normalization / alpha) : 0.0f;
+            }
+        }
+
+        cs->fromNormalisedChannelsValue(dstPixel, pixel);
+    }
+
+    device->writeBytes(bytes.constData(), rect);
+}
+
+}
 
 
 KisLensBlurFilter::KisLensBlurFilter() : KisFilter(id(), FiltersCategoryBlurId, i18n("&Lens Blur..."))
@@ -57,6 +331,12 @@ KisConfigWidget * KisLensBlurFilter::createConfigurationWidget(QWidget* parent,
 
 QSize KisLensBlurFilter::getKernelHalfSize(const KisFilterConfigurationSP config, int lod)
 {
+    if (config->getString("irisShape") == "Circle") {
+        KisLodTransformScalar t(lod);
+        const int radius = circleKernelRadius(t.scale(config->getInt("irisRadius", 5)));
+        return QSize(radius, radius);
+    }
+
     QPolygonF iris = getIrisPolygon(config, lod);
     QRect rect = iris.boundingRect().toAlignedRect();
 
@@ -72,6 +352,7 @@ KisFilterConfigurationSP KisLensBlurFilter::factoryConfiguration() const
     config->setProperty("irisShape", "Pentagon (5)");
     config->setProperty("irisRadius", 5);
     config->setProperty("irisRotation", 0);
+    config->setProperty("quality", 3);
 
     QSize halfSize = getKernelHalfSize(config, 0);
     config->setProperty("halfWidth", halfSize.width());
@@ -145,6 +426,17 @@ void KisLensBlurFilter::processImpl(KisPaintDeviceSP device,
     }
 
     const int lod = device->defaultBounds()->currentLevelOfDetail();
+
+    if (config->getString("irisShape") == "Circle") {
+        KisLodTransformScalar t(lod);
+        const int irisRadius = t.scale(config->getInt("irisRadius", 5));
+        if (irisRadius < 1) return;
+
+        applyCircleBlur(device, rect, irisRadius, config->getInt("quality", 3),
+                        channelFlags, progressUpdater);
+        return;
+    }
+
     QPolygonF transformedIris = getIrisPolygon(config, lod);
     if (transformedIris.isEmpty()) return;
 
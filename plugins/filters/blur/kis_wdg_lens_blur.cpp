@@ -41,6 +41,12 @@ KisWdgLensBlur::KisWdgLensBlur(QWidget * parent) : KisConfigWidget(parent)
     connect(m_widget->irisShapeCombo, SIGNAL(currentIndexChanged(int)), SIGNAL(sigConfigurationItemChanged()));
     connect(m_widget->irisRadiusSlider, SIGNAL(valueChanged(int)), SIGNAL(sigConfigurationItemChanged()));
     connect(m_widget->irisRotationSlider, SIGNAL(valueChanged(int)), SIGNAL(sigConfigurationItemChanged()));
+    connect(m_widget->qualityCombo, SIGNAL(currentIndexChanged(int)), SIGNAL(sigConfigurationItemChanged()));
+
+    connect(m_widget->irisShapeCombo, SIGNAL(currentIndexChanged(int)), SLOT(slotIrisShapeChanged()));
+
+    m_widget->qualityCombo->setCurrentIndex(2);
+    slotIrisShapeChanged();
 }
 
 KisWdgLensBlur::~KisWdgLensBlur()
@@ -54,6 +60,7 @@ KisPropertiesConfigurationSP KisWdgLensBlur::configuration() const
     config->setProperty("irisShape", m_widget->irisShapeCombo->currentText());
     config->setProperty("irisRadius", m_widget->irisRadiusSlider->value());
     config->setProperty("irisRotation", m_widget->irisRotationSlider->value());
+    config->setProperty("quality", m_widget->qualityCombo->currentIndex() + 1);
 
     QSize halfSize = KisLensBlurFilter::getKernelHalfSize(config, 0);
     config->setProperty("halfWidth", halfSize.width());
@@ -78,5 +85,17 @@ void KisWdgLensBlur::setConfiguration(const KisPropertiesConfigurationSP config)
     if (config->getProperty("irisRotation", value)) {
         m_widget->irisRotationSlider->setValue(value.toInt());
     }
+    if (config->getProperty("quality", value)) {
+        m_widget->qualityCombo->setCurrentIndex(qBound(0, value.toInt() - 1, m_widget->qualityCombo->count() - 1));
+    }
+}
+
+void KisWdgLensBlur::slotIrisShapeChanged()
+{
+    // the circular iris is approximated with separable components
+    const bool isCircle = m_widget->irisShapeCombo->currentText() == "Circle";
+
+    m_widget->irisRotationSlider->setEnabled(!isCircle);
+    m_widget->qualityCombo->setEnabled(isCircle);
 }
 
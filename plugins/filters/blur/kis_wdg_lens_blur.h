@@ -36,6 +36,10 @@ public:
     }
     void setConfiguration(const KisPropertiesConfigurationSP) override;
     KisPropertiesConfigurationSP configuration() const override;
+
+private Q_SLOTS:
+    void slotIrisShapeChanged();
+
 private:
     Ui_WdgLensBlur* m_widget;
 };
@@ -19,12 +19,15 @@
  */
 #include <cmath>
 #include <QtMath>
+#include <QMutex>
+#include <QtConcurrent>
 
 #include <kpluginfactory.h>
 #include <klocalizedstring.h>
 
 #include <KoUpdater.h>
 #include <KoCompositeOps.h>
+#include <KoCompositeOp.h>
 
 #include <filter/kis_filter_category_ids.h>
 #include "kis_filter_configuration.h"
@@ -33,7 +36,7 @@
 #include <kis_random_accessor_ng.h>
 #include <kis_sequential_iterator.h>
 #include <kis_types.h>
-#include <kis_painter.h>
+#include <kis_algebra_2d.h>
 #include <kis_pixel_selection.h>
 #include <kis_selection.h>
 
@@ -63,6 +66,21 @@ KisHalftoneFilter::KisHalftoneFilter()
     setSupportsThreading(false);
 }
 
+namespace {
+
+struct HalftoneDot {
+    QPointF center;
+    qreal radius;
+    QRect clipRect;
+};
+
+struct HalftoneBand {
+    QRect rect;
+    QVector<int> dots;
+};
+
+}
+
 //I am pretty terrible at trigionometry, hence all the comments.
 void KisHalftoneFilter::processImpl(KisPaintDeviceSP device,
                                     const QRect &applyRect,
@@ -96,78 +114,157 @@ void KisHalftoneFilter::processImpl(KisPaintDeviceSP device,
         cellOffsetV = qTan(qDegreesToRadians(90-angle))*cellSpacingV;
     }
 
-    QPolygonF gridPoints;
     QRect totalRect(QPoint(0,0), applyRect.bottomRight());
-    if (gridPoints.size()<1) {
-        int rows = (totalRect.height()/cellSpacingV)+3;
-        for (int r=0; r<rows; r++) {
-            qreal offset = fmod(((qreal)r*cellOffsetV), cellSpacingH);
-            int columns = ((totalRect.width()+offset)/cellSpacingH)+3;
-            for (int c = 0; c<columns; c++) {
-                gridPoints.append(QPointF((c*cellSpacingH)+offset-cellSpacingH,
-                                            r*cellSpacingV-cellSpacingV));
-            }
-        }
-    }
-    //qDebug()<<applyRect;
-    //qDebug()<<device->exactBounds();
-    if (progressUpdater) {
-        progressUpdater->setRange(0, (applyRect.height()/cellSpacingV+3)*(applyRect.width()/cellSpacingH+3));
-    }
-    KisRandomConstAccessorSP itterator = device->createRandomConstAccessorNG( 0, 0);
-    //itterator->numContiguousColumns(qCeil(cellSize));
-    //itterator->numContiguousRows(qCeil(cellSize));
-    KisPainter painter(device);
-    painter.setCompositeOp(device->colorSpace()->compositeOp(COMPOSITE_OVER));
-    KisPaintDeviceSP dab = device->createCompositionSourceDevice();
-    KisPainter dbPainter(dab);
-    KisSelectionSP alpha = new KisSelection();
-    alpha->pixelSelection()->copyAlphaFrom(device, applyRect);
-    device->fill(applyRect, backgroundC);
-    dbPainter.setAntiAliasPolygonFill(config->getBool("antiAliasing", true));
-    dbPainter.setPaintColor(foregroundC);
-    dbPainter.setFillStyle(KisPainter::FillStyleForegroundColor);
-    dbPainter.setCompositeOp(device->colorSpace()->compositeOp(COMPOSITE_OVER));
+    QRect cellRect(applyRect.topLeft()-QPoint(qFloor(cellSpacingH), qFloor(qMax(cellSpacingV, diameter))), applyRect.bottomRight()+QPoint(qCeil(cellSpacingH), qCeil(qMax(cellSpacingV, diameter))));
+
+    const KoColorSpace *cs = device->colorSpace();
+    const int pixelSize = cs->pixelSize();
+
     quint8 eightbit = 255;
     if (config->getBool("invert", false)) {
         eightbit = 0;
     }
 
-    QRect cellRect(applyRect.topLeft()-QPoint(qFloor(cellSpacingH), qFloor(qMax(cellSpacingV, diameter))), applyRect.bottomRight()+QPoint(qCeil(cellSpacingH), qCeil(qMax(cellSpacingV, diameter))));
-    for (int i=0; i<gridPoints.size(); i++) {
-        QPointF samplePoint = gridPoints.at(i);
-        if (cellRect.contains(samplePoint.toPoint())) {
-            qint32 xdifference = qFloor(samplePoint.x())- applyRect.left();
-            qint32 ydifference = qFloor(samplePoint.y())- applyRect.top();
+    /**
+     * Sample the intensities of all the cells first, so that the
+     * bands could be written in any order. The dot of every cell is
+     * clipped by the square of the diameter starting at its grid point.
+     */
+    QVector<HalftoneDot> dots;
+    KisRandomConstAccessorSP itterator = device->createRandomConstAccessorNG( 0, 0);
+
+    int rows = (totalRect.height()/cellSpacingV)+3;
+    for (int r=0; r<rows; r++) {
+        const qreal y = r*cellSpacingV-cellSpacingV;
+        if (y < cellRect.top() - 1 || y > cellRect.bottom() + 1) continue;
+
+        qreal offset = fmod(((qreal)r*cellOffsetV), cellSpacingH);
+        int columns = ((totalRect.width()+offset)/cellSpacingH)+3;
+        for (int c = 0; c<columns; c++) {
+            QPointF samplePoint((c*cellSpacingH)+offset-cellSpacingH, y);
+            if (!cellRect.contains(samplePoint.toPoint())) continue;
+
             QPoint center(qBound(applyRect.left()+1, qFloor(samplePoint.x())+qCeil(cellSize*0.5), applyRect.right()-1),
                           qBound(applyRect.top()+1, qFloor(samplePoint.y())+qCeil(cellSize*0.5), applyRect.bottom()-1));
             itterator->moveTo(center.x(), center.y());
-            quint8 intensity = device->colorSpace()->intensity8(itterator->oldRawData());
+            quint8 intensity = cs->intensity8(itterator->oldRawData());
             qreal size = diameter*((qAbs(intensity-eightbit))/255.0);
-            QPoint sPoint(qMax(qFloor(samplePoint.x()), applyRect.left()),
-                          qMax(qFloor(samplePoint.y()), applyRect.top()));
-            dbPainter.bitBlt(0, 0, device,
-                             sPoint.x(),
-                             sPoint.y(),
-                             diameter,
-                             diameter);
-            dbPainter.paintEllipse((samplePoint.x()-qFloor(samplePoint.x()))+qCeil(size)-size,
-                                   (samplePoint.y()-qFloor(samplePoint.y()))+qCeil(size)-size,
-                                   size,
-                                   size);
-            dab->crop(qAbs(qMin(0, xdifference)),
-                      qAbs(qMin(0, ydifference)),
-                      diameter,
-                      diameter);
-            //we only want to paint the bits actually in the apply rect...)
-            painter.bitBlt(sPoint,
-                           dab,
-                           dab->exactBounds());
-            if (progressUpdater) {
-                progressUpdater->setValue(i);
+            if (size <= 0) continue;
+
+            HalftoneDot dot;
+            dot.center = samplePoint + QPointF(qCeil(size) - 0.5 * size, qCeil(size) - 0.5 * size);
+            dot.radius = 0.5 * size;
+            dot.clipRect = QRect(qFloor(samplePoint.x()), qFloor(samplePoint.y()), int(diameter), int(diameter)) & applyRect;
+
+            if (!dot.clipRect.isEmpty()) {
+                dots.append(dot);
             }
         }
     }
+
+    /**
+     * All the dots have the same color, so painting them one over
+     * another is the same as painting the foreground color over the
+     * background with the opacity of the united coverage of the dots.
+     * Compose the colors for every opacity in advance.
+     */
+    QVector<quint8> colors(256 * pixelSize);
+    {
+        QVector<quint8> foreground(256 * pixelSize);
+        QVector<quint8> opacity(256);
+
+        for (int i = 0; i < 256; i++) {
+            memcpy(colors.data() + i * pixelSize, backgroundC.data(), pixelSize);
+            memcpy(foreground.data() + i * pixelSize, foregroundC.data(), pixelSize);
+            opacity[i] = i;
+        }
+
+        cs->compositeOp(COMPOSITE_OVER)->composite(colors.data(), 256 * pixelSize,
+                                                   foreground.constData(), 256 * pixelSize,
+                                                   opacity.constData(), 256,
+                                                   1, 256, OPACITY_OPAQUE_U8);
+    }
+
+    /**
+     * The bands are aligned to the tiles of the device, so that every
+     * tile is written by a single thread only.
+     */
+    const int bandHeight = 64;
+    const int firstBandRow = KisAlgebra2D::divideFloor(applyRect.top(), bandHeight);
+
+    QVector<HalftoneBand> bands;
+    for (int y = applyRect.top(); y <= applyRect.bottom();) {
+        const int nextY = qMin((KisAlgebra2D::divideFloor(y, bandHeight) + 1) * bandHeight, applyRect.bottom() + 1);
+
+        HalftoneBand band;
+        band.rect = QRect(applyRect.x(), y, applyRect.width(), nextY - y);
+        bands << band;
+
+        y = nextY;
+    }
+
+    for (int i = 0; i < dots.size(); i++) {
+        const QRect &rc = dots[i].clipRect;
+        const int firstBand = KisAlgebra2D::divideFloor(rc.top(), bandHeight) - firstBandRow;
+        const int lastBand = KisAlgebra2D::divideFloor(rc.bottom(), bandHeight) - firstBandRow;
+
+        for (int j = firstBand; j <= lastBand; j++) {
+            bands[j].dots.append(i);
+        }
+    }
+
+    KisSelectionSP alpha = new KisSelection();
+    alpha->pixelSelection()->copyAlphaFrom(device, applyRect);
+
+    const bool antiAliasing = config->getBool("antiAliasing", true);
+
+    QMutex progressMutex;
+    int bandsProcessed = 0;
+    if (progressUpdater) {
+        progressUpdater->setRange(0, bands.size());
+    }
+
+    auto processBand = [&] (const HalftoneBand &halftoneBand) {
+        const QRect &band = halftoneBand.rect;
+        QVector<float> transparency(band.width() * band.height(), 1.0f);
+
+        Q_FOREACH (int i, halftoneBand.dots) {
+            const HalftoneDot &dot = dots[i];
+            const QRect dotRect(qFloor(dot.center.x() - dot.radius - 1), qFloor(dot.center.y() - dot.radius - 1),
+                                qCeil(2 * dot.radius) + 3, qCeil(2 * dot.radius) + 3);
+            const QRect rc = dotRect & dot.clipRect & band;
+
+            for (int y = rc.top(); y <= rc.bottom(); y++) {
+                const qreal dy = y + 0.5 - dot.center.y();
+                float *dst = transparency.data() + (y - band.top()) * band.width() + rc.left() - band.left();
+
+                for (int x = rc.left(); x <= rc.right(); x++, dst++) {
+                    const qreal dx = x + 0.5 - dot.center.x();
+                    const qreal distance = std::sqrt(dx * dx + dy * dy);
+                    const qreal coverage = antiAliasing ?
+                        qBound(0.0, dot.radius + 0.5 - distance, 1.0) :
+                        (distance <= dot.radius ? 1.0 : 0.0);
+
+                    *dst *= 1.0 - coverage;
+                }
+            }
+        }
+
+        KisSequentialIterator dstIt(device, band);
+        const float *src = transparency.constData();
+        while (dstIt.nextPixel()) {
+            const int opacity = qRound((1.0f - *src++) * 255);
+            memcpy(dstIt.rawData(), colors.constData() + opacity * pixelSize, pixelSize);
+        }
+
+        if (progressUpdater) {
+            QMutexLocker l(&progressMutex);
+            progressUpdater->setValue(++bandsProcessed);
+        }
+    };
+
+    QtConcurrent::blockingMap(bands, processBand);
+
     alpha->pixelSelection()->invert();
     device->clearSelection(alpha);
 }
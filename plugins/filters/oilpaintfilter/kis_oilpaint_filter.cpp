@@ -27,6 +27,7 @@
 
 #include <stdlib.h>
 #include <vector>
+#include <algorithm>
 
 #include <QPoint>
 #include <QSpinBox>
@@ -37,10 +38,11 @@
 #include <kpluginfactory.h>
 
 #include <KoUpdater.h>
+#include <KoColorSpace.h>
 
 #include <KisDocument.h>
 #include <kis_image.h>
-#include <KisSequentialIteratorProgress.h>
+#include <kis_progress_update_helper.h>
 #include <kis_layer.h>
 #include <filter/kis_filter_registry.h>
 #include <kis_global.h>
@@ -74,6 +76,20 @@ void KisOilPaintFilter::processImpl(KisPaintDeviceSP device,
     OilPaint(device, device, applyRect, brushSize, smooth, progressUpdater);
 }
 
+namespace {
+
+/**
+ * The bins and the normalised channels of one row of the processed
+ * rect. They are calculated only once per pixel instead of once per
+ * every window the pixel belongs to.
+ */
+struct CachedRow {
+    QVector<int> bins;
+    QVector<float> channels;
+};
+
+}
+
 // This method have been ported from Pieter Z. Voloshyn algorithm code.
 
 /* Function to apply the OilPaint effect.
@@ -91,11 +107,115 @@ void KisOilPaintFilter::processImpl(KisPaintDeviceSP device,
 void KisOilPaintFilter::OilPaint(const KisPaintDeviceSP src, KisPaintDeviceSP dst, const QRect &applyRect,
                                  int BrushSize, int Smoothness, KoUpdater* progressUpdater) const
 {
-    KisSequentialConstIteratorProgress it(src, applyRect, progressUpdater);
-    KisSequentialIterator dstIt(dst, applyRect);
+    const KoColorSpace* cs = src->colorSpace();
+    const int pixelSize = cs->pixelSize();
+    const int numChannels = cs->channelCount();
+    const double scale = Smoothness / 255.0;
+
+    const int left = applyRect.left();
+    const int right = applyRect.right();
+    const int width = applyRect.width();
+
+    /**
+     * The filter is applied in-place, that is the windows of the pixels
+     * contain the pixels written earlier. To keep the result exactly the
+     * same as before, the written pixels are put back into the cached
+     * rows and the histogram, and the rows are processed in order.
+     */
+    const int ringSize = 2 * BrushSize + 1;
+    QVector<CachedRow> rows(ringSize);
+    QVector<quint8> rowBytes(width * pixelSize);
+    QVector<float> channel(numChannels);
+
+    auto cachedRow = [&] (int y) -> CachedRow& {
+        return rows[(y - applyRect.top()) % ringSize];
+    };
+
+    auto updateCache = [&] (CachedRow &row, int x, const quint8 *pixel) {
+        const int i = x - left;
+        cs->normalisedChannelsValue(pixel, channel);
+        std::copy(channel.begin(), channel.end(), row.channels.begin() + i * numChannels);
+        row.bins[i] = (uint)(cs->intensity8(pixel) * scale);
+    };
+
+    int lastLoadedRow = applyRect.top() - 1;
+
+    auto loadRow = [&] (int y) {
+        CachedRow &row = cachedRow(y);
+        row.bins.resize(width);
+        row.channels.resize(width * numChannels);
+
+        src->readBytes(rowBytes.data(), left, y, width, 1);
+        for (int x = left; x <= right; x++) {
+            updateCache(row, x, rowBytes.data() + (x - left) * pixelSize);
+        }
+    };
+
+    QVector<int> intensityCount(Smoothness + 1);
+    int rowStart = 0;
+    int rowEnd = 0;
+
+    auto updateColumn = [&] (int x, int delta) {
+        for (int y = rowStart; y <= rowEnd; y++) {
+            intensityCount[cachedRow(y).bins[x - left]] += delta;
+        }
+    };
+
+    KisProgressUpdateHelper progress(progressUpdater, 100, applyRect.height());
+
+    for (int Y = applyRect.top(); Y <= applyRect.bottom(); Y++) {
+        rowStart = qMax(Y - BrushSize, applyRect.top());
+        rowEnd = qMin(rowStart + 2 * BrushSize, applyRect.bottom());
+
+        while (lastLoadedRow < rowEnd) {
+            loadRow(++lastLoadedRow);
+        }
+
+        std::fill(intensityCount.begin(), intensityCount.end(), 0);
+
+        int columnStart = left;
+        int columnEnd = qMin(left + 2 * BrushSize, right);
+
+        for (int x = columnStart; x <= columnEnd; x++) {
+            updateColumn(x, 1);
+        }
 
-    while (it.nextPixel() && dstIt.nextPixel()) {
-        MostFrequentColor(src, dstIt.rawData(), applyRect, it.x(), it.y(), BrushSize, Smoothness);
+        for (int X = left; X <= right; X++) {
+            const int newColumnStart = qMax(X - BrushSize, left);
+            const int newColumnEnd = qMin(newColumnStart + 2 * BrushSize, right);
+
+            while (columnStart < newColumnStart) {
+                updateColumn(columnStart++, -1);
+            }
+
+            while (columnEnd < newColumnEnd) {
+                updateColumn(++columnEnd, 1);
+            }
+
+            quint8 *dstPixel = rowBytes.data() + (X - left) * pixelSize;
+            MostFrequentColor(cs, dstPixel, intensityCount,
+                              [&] (int I, QVector<float> &sum) {
+                                  for (int y = rowStart; y <= rowEnd; y++) {
+                                      const CachedRow &row = cachedRow(y);
+                                      for (int x = columnStart; x <= columnEnd; x++) {
+                                          if (row.bins[x - left] != I) continue;
+
+                                          const float *channels = row.channels.constData() + (x - left) * numChannels;
+                                          for (int i = 0; i < numChannels; i++) {
+                                              sum[i] += channels[i];
+                                          }
+                                      }
+                                  }
+                              });
+
+            CachedRow &row = cachedRow(Y);
+            intensityCount[row.bins[X - left]]--;
+            updateCache(row, X, dstPixel);
+            intensityCount[row.bins[X - left]]++;
+        }
+
+        dst->writeBytes(rowBytes.constData(), left, Y, width, 1);
+        progress.step();
     }
 }
 
@@ -103,64 +223,23 @@ void KisOilPaintFilter::OilPaint(const KisPaintDeviceSP src, KisPaintDeviceSP ds
 
 /* Function to determine the most frequent color in a matrix
  *
- * Bits             => Bits array
- * Width            => Image width
- * Height           => Image height
- * X                => Position horizontal
- * Y                => Position vertical
- * Radius           => Is the radius of the matrix to be analyzed
- * Intensity        => Intensity to calculate
+ * IntensityCount   => The histogram of the intensities of the matrix
+ * sumChannels      => Sums the channels of the pixels of the matrix
+ *                     with the given intensity
  *
- * Theory           => This function creates a matrix with the analyzed pixel in
+ * Theory           => This function takes the matrix with the analyzed pixel in
  *                     the center of this matrix and find the most frequenty color
  */
 
-void KisOilPaintFilter::MostFrequentColor(KisPaintDeviceSP src, quint8* dst, const QRect& bounds, int X, int Y, int Radius, int Intensity) const
+template <class SumChannelsFunc>
+void KisOilPaintFilter::MostFrequentColor(const KoColorSpace *cs, quint8* dst,
+                                          const QVector<int> &IntensityCount,
+                                          SumChannelsFunc sumChannels) const
 {
-    uint I;
-
-    double Scale = Intensity / 255.0;
-
-    // Alloc some arrays to be used
-    uchar *IntensityCount = new uchar[(Intensity + 1) * sizeof(uchar)];
-
-    const KoColorSpace* cs = src->colorSpace();
-
-    QVector<float> channel(cs->channelCount());
-    QVector<float>* AverageChannels = new QVector<float>[(Intensity + 1)];
-
-    // Erase the array
-    memset(IntensityCount, 0, (Intensity + 1) * sizeof(uchar));
-
-    int startx = qMax(X - Radius, bounds.left());
-    int starty = qMax(Y - Radius, bounds.top());
-    int width = (2 * Radius) + 1;
-    if ((startx + width - 1) > bounds.right()) width = bounds.right() - startx + 1;
-    Q_ASSERT((startx + width - 1) <= bounds.right());
-    int height = (2 * Radius) + 1;
-    if ((starty + height) > bounds.bottom()) height = bounds.bottom() - starty + 1;
-    Q_ASSERT((starty + height - 1) <= bounds.bottom());
-    KisSequentialConstIterator srcIt(src, QRect(startx, starty, width, height));
-    while (srcIt.nextPixel()) {
-
-        cs->normalisedChannelsValue(srcIt.rawDataConst(), channel);
-
-        I = (uint)(cs->intensity8(srcIt.rawDataConst()) * Scale);
-        IntensityCount[I]++;
-
-        if (IntensityCount[I] == 1) {
-            AverageChannels[I] = channel;
-        } else {
-            for (int i = 0; i < channel.size(); i++) {
-                AverageChannels[I][i] += channel[i];
-            }
-        }
-    }
-
-    I = 0;
+    int I = 0;
     int MaxInstance = 0;
 
-    for (int i = 0 ; i <= Intensity ; ++i) {
+    for (int i = 0 ; i < IntensityCount.size() ; ++i) {
         if (IntensityCount[i] > MaxInstance) {
             I = i;
             MaxInstance = IntensityCount[i];
@@ -168,7 +247,13 @@ void KisOilPaintFilter::MostFrequentColor(KisPaintDeviceSP src, quint8* dst, con
     }
 
     if (MaxInstance != 0) {
-        channel = AverageChannels[I];
+        /**
+         * The channels are summed in the same order as the pixels are
+         * stored in the window, so the rounding is the same as it used
+         * to be when the sums were accumulated for every intensity.
+         */
+        QVector<float> channel(cs->channelCount(), 0.0f);
+        sumChannels(I, channel);
         for (int i = 0; i < channel.size(); i++) {
             channel[i] /= MaxInstance;
         }
@@ -177,10 +262,6 @@ void KisOilPaintFilter::MostFrequentColor(KisPaintDeviceSP src, quint8* dst, con
         memset(dst, 0, cs->pixelSize());
         cs->setOpacity(dst, OPACITY_OPAQUE_U8, 1);
     }
-
-
-    delete [] IntensityCount;        // free all the arrays
-    delete [] AverageChannels;
 }
 
 
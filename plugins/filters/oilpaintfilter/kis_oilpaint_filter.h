@@ -24,6 +24,8 @@
 #include "filter/kis_filter.h"
 #include "kis_config_widget.h"
 
+class KoColorSpace;
+
 class KisOilPaintFilter : public KisFilter
 {
 public:
@@ -45,7 +47,10 @@ public:
 private:
     void OilPaint(const KisPaintDeviceSP src, KisPaintDeviceSP dst, const QRect &applyRect,
                   int BrushSize, int Smoothness, KoUpdater* progressUpdater) const;
-    void MostFrequentColor(KisPaintDeviceSP src, quint8* dst, const QRect& bounds, int X, int Y, int Radius, int Intensity) const;
+    template <class SumChannelsFunc>
+    void MostFrequentColor(const KoColorSpace *cs, quint8* dst,
+                           const QVector<int> &IntensityCount,
+                           SumChannelsFunc sumChannels) const;
 };
 
 #endif
@@ -47,10 +47,10 @@
 #include <filter/kis_filter_category_ids.h>
 #include <filter/kis_filter_configuration.h>
 #include <kis_processing_information.h>
+#include <kis_sequential_iterator.h>
 
 #include "widgets/kis_multi_integer_filter_widget.h"
 #include <KoMixColorsOp.h>
-#include <KisSequentialIteratorProgress.h>
 #include "kis_algebra_2d.h"
 #include "kis_lod_transform.h"
 
@@ -80,9 +80,6 @@ void KisPixelizeFilter::processImpl(KisPaintDeviceSP device,
 
     const QRect deviceBounds = device->defaultBounds()->bounds();
 
-    const int bufferSize = pixelSize * pixelWidth * pixelHeight;
-    QScopedArrayPointer<quint8> buffer(new quint8[bufferSize]);
-
     KoColor pixelColor(Qt::black, device->colorSpace());
     KoMixColorsOp *mixOp = device->colorSpace()->mixColorsOp();
 
@@ -93,38 +90,101 @@ void KisPixelizeFilter::processImpl(KisPaintDeviceSP device,
     const qint32 lastCol = divideFloor(applyRect.x() + applyRect.width() - 1, pixelWidth);
     const qint32 lastRow = divideFloor(applyRect.y() + applyRect.height() - 1, pixelHeight);
 
+    /**
+     * The whole row of the cells is read and written at once, the
+     * cells are only gathered into a continuous buffer for mixing.
+     */
+    const QRect rowsRect(firstCol * pixelWidth, firstRow * pixelHeight,
+                         (lastCol - firstCol + 1) * pixelWidth,
+                         (lastRow - firstRow + 1) * pixelHeight);
+
+    const int rowStride = rowsRect.width() * pixelSize;
+    QVector<quint8> rowBuffer(rowStride * pixelHeight);
+    QVector<quint8> cellBuffer(pixelSize * pixelWidth * pixelHeight);
+
     progressUpdater->setRange(firstRow, lastRow);
 
     for(qint32 i = firstRow; i <= lastRow; i++) {
+        const QRect readRect = QRect(rowsRect.x(), i * pixelHeight,
+                                     rowsRect.width(), pixelHeight) & deviceBounds;
+
+        if (readRect.isEmpty()) {
+            progressUpdater->setValue(i);
+            continue;
+        }
+
+        /**
+         * The neighbouring patches may have already been written into
+         * the device, so the cells are read from the old data
+         */
+        KisSequentialConstIterator srcIt(device, readRect);
+        quint8 *bufferPtr = rowBuffer.data();
+
+        int numConseqPixels = srcIt.nConseqPixels();
+        while (srcIt.nextPixels(numConseqPixels)) {
+            numConseqPixels = srcIt.nConseqPixels();
+
+            const int numBytes = numConseqPixels * pixelSize;
+            memcpy(bufferPtr, srcIt.oldRawData(), numBytes);
+            bufferPtr += numBytes;
+        }
+
+        const int readStride = readRect.width() * pixelSize;
+
         for(qint32 j = firstCol; j <= lastCol; j++) {
             const QRect maxPatchRect(j * pixelWidth, i * pixelHeight,
                                      pixelWidth, pixelHeight);
             const QRect pixelRect = maxPatchRect & deviceBounds;
             const int numColors = pixelRect.width() * pixelRect.height();
 
+            if (!numColors) continue;
 
             //read
-            KisSequentialConstIterator srcIt(device, pixelRect);
-
-            memset(buffer.data(), 0, bufferSize);
-            quint8 *bufferPtr = buffer.data();
-
-            while (srcIt.nextPixel()) {
-                memcpy(bufferPtr, srcIt.oldRawData(), pixelSize);
-                bufferPtr += pixelSize;
+            const int cellStride = pixelRect.width() * pixelSize;
+            quint8 *cellPtr = cellBuffer.data();
+            quint8 *rowPtr = rowBuffer.data() +
+                (pixelRect.y() - readRect.y()) * readStride +
+                (pixelRect.x() - readRect.x()) * pixelSize;
+
+            for (int y = 0; y < pixelRect.height(); y++) {
+                memcpy(cellPtr, rowPtr, cellStride);
+                cellPtr += cellStride;
+                rowPtr += readStride;
             }
 
             // mix all the colors
-            mixOp->mixColors(buffer.data(), numColors, pixelColor.data());
+            mixOp->mixColors(cellBuffer.data(), numColors, pixelColor.data());
 
             // write only colors in applyRect
             const QRect writeRect = pixelRect & applyRect;
+            if (writeRect.isEmpty()) continue;
+
+            rowPtr = rowBuffer.data() +
+                (writeRect.y() - readRect.y()) * readStride +
+                (writeRect.x() - readRect.x()) * pixelSize;
+
+            for (int x = 0; x < writeRect.width(); x++) {
+                memcpy(rowPtr + x * pixelSize, pixelColor.data(), pixelSize);
+            }
 
-            KisSequentialIterator dstIt(device, writeRect);
-            while (dstIt.nextPixel()) {
-                memcpy(dstIt.rawData(), pixelColor.data(), pixelSize);
+            for (int y = 1; y < writeRect.height(); y++) {
+                memcpy(rowPtr + y * readStride, rowPtr, writeRect.width() * pixelSize);
             }
         }
+
+        const QRect writeRect = readRect & applyRect;
+        if (!writeRect.isEmpty()) {
+            const quint8 *writePtr = rowBuffer.constData() +
+                (writeRect.y() - readRect.y()) * readStride +
+                (writeRect.x() - readRect.x()) * pixelSize;
+
+            for (int y = 0; y < writeRect.height(); y++) {
+                device->writeBytes(writePtr + y * readStride,
+                                   writeRect.x(), writeRect.y() + y,
+                                   writeRect.width(), 1);
+            }
+        }
+
         progressUpdater->setValue(i);
     }
 }
@@ -26,6 +26,9 @@
 #include "kis_pixel_selection.h"
 #include "kis_transaction.h"
 #include <KoColorSpaceRegistry.h>
+#include <KoColor.h>
+#include <kis_global.h>
+#include <QtMath>
 #include <sdk/tests/qimage_test_util.h>
 #include <sdk/tests/testing_timed_default_bounds.h>
 
@@ -189,6 +192,55 @@ bool testFilterWithSelections(KisFilterSP f)
     return true;
 }
 
+/**
+ * Applies the filter to the device in several small patches, like the
+ * filter stroke does, and compares the result to the single-pass one.
+ * The patches are applied in-place, so every patch must read the
+ * original data even when its neighbours have already been filtered.
+ */
+bool testFilterInPatches(KisFilterSP f, KisFilterConfigurationSP kfc)
+{
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    QImage qimage(QString(FILES_DATA_DIR) + QDir::separator() + "carrot.png");
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    dev->setDefaultBounds(new TestUtil::TestingTimedDefaultBounds(qimage.rect()));
+    dev->convertFromQImage(qimage, 0, 0, 0);
+
+    KisPaintDeviceSP patchedDev = new KisPaintDevice(*dev);
+
+    {
+        KisTransaction transaction(dev);
+        f->process(dev, qimage.rect(), kfc);
+    }
+
+    {
+        KisTransaction transaction(patchedDev);
+
+        const QSize patchSize(37, 29);
+        for (int y = 0; y < qimage.height(); y += patchSize.height()) {
+            for (int x = 0; x < qimage.width(); x += patchSize.width()) {
+                f->process(patchedDev, QRect(QPoint(x, y), patchSize) & qimage.rect(), kfc);
+            }
+        }
+    }
+
+    QPoint errpoint;
+
+    QImage result = dev->convertToQImage(0, 0, 0, qimage.width(), qimage.height());
+    QImage actualResult = patchedDev->convertToQImage(0, 0, 0, qimage.width(), qimage.height());
+
+    if (!TestUtil::compareQImages(errpoint, result, actualResult, 1, 1)) {
+        qDebug() << "Failed compare patched result images for: " << f->id();
+        qDebug() << errpoint;
+        actualResult.save(QString("carrot_%1_patched.png").arg(f->id()));
+        result.save(QString("carrot_%1_patched_expected.png").arg(f->id()));
+        return false;
+    }
+
+    return true;
+}
+
 void KisAllFilterTest::testAllFilters()
 {
     QStringList excludeFilters;
@@ -283,6 +335,172 @@ void KisAllFilterTest::testAllFiltersWithSelections()
     }
 }
 
+void KisAllFilterTest::testPixelizeInPatches()
+{
+    KisFilterSP f = KisFilterRegistry::instance()->value("pixelize");
+    QVERIFY(f);
+
+    KisFilterConfigurationSP kfc = f->defaultConfiguration();
+    kfc->setProperty("pixelWidth", 13);
+    kfc->setProperty("pixelHeight", 11);
+
+    QVERIFY(testFilterInPatches(f, kfc));
+}
+
+void KisAllFilterTest::testHalftone()
+{
+    KisFilterSP f = KisFilterRegistry::instance()->value("halftone");
+    QVERIFY(f);
+
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    const QRect rect(0, 0, 256, 256);
+
+    KisFilterConfigurationSP kfc = f->defaultConfiguration();
+    kfc->setProperty("cellSize", 8);
+    kfc->setProperty("patternAngle", 45);
+    kfc->setProperty("antiAliasing", true);
+    kfc->setProperty("invert", false);
+
+    /**
+     * On a flat image all the dots are the same, so the result doesn't
+     * depend on the way the rect is split into patches (and bands)
+     */
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    dev->setDefaultBounds(new TestUtil::TestingTimedDefaultBounds(rect));
+    dev->fill(rect, KoColor(QColor(128, 128, 128), cs));
+
+    KisPaintDeviceSP patchedDev = new KisPaintDevice(*dev);
+
+    {
+        KisTransaction transaction(dev);
+        f->process(dev, rect, kfc);
+    }
+
+    {
+        KisTransaction transaction(patchedDev);
+
+        const QSize patchSize(37, 29);
+        for (int y = 0; y < rect.height(); y += patchSize.height()) {
+            for (int x = 0; x < rect.width(); x += patchSize.width()) {
+                f->process(patchedDev, QRect(QPoint(x, y), patchSize) & rect, kfc);
+            }
+        }
+    }
+
+    QImage result = dev->convertToQImage(0, rect);
+    QImage patchedResult = patchedDev->convertToQImage(0, rect);
+
+    QPoint errpoint;
+    if (!TestUtil::compareQImages(errpoint, result, patchedResult)) {
+        qDebug() << "First different pixel:" << errpoint;
+        result.save("halftone_expected.png");
+        patchedResult.save("halftone_patched.png");
+        QFAIL("Halftone result depends on the patches");
+    }
+
+    /**
+     * A dot of the mid-grey cell has the diameter of 127/255 of the
+     * cell's diagonal, and the cells don't overlap, so the mean
+     * coverage is the area of the dot divided by the area of the cell
+     */
+    const qreal cellSize = 8.0;
+    const qreal dotRadius = 0.5 * qSqrt(2.0) * cellSize * 127.0 / 255.0;
+    const qreal expectedCoverage = M_PI * pow2(dotRadius) / pow2(cellSize);
+
+    const QRect interiorRect = rect.adjusted(32, 32, -32, -32);
+    qreal coverage = 0.0;
+    for (int y = interiorRect.top(); y <= interiorRect.bottom(); y++) {
+        for (int x = interiorRect.left(); x <= interiorRect.right(); x++) {
+            coverage += 1.0 - qGray(result.pixel(x, y)) / 255.0;
+        }
+    }
+    coverage /= interiorRect.width() * interiorRect.height();
+
+    QVERIFY2(qAbs(coverage - expectedCoverage) < 0.02,
+             QString("coverage %1, expected %2").arg(coverage).arg(expectedCoverage).toLatin1());
+
+    // the alpha of the source is kept
+    QImage alphaImage(rect.size(), QImage::Format_ARGB32);
+    for (int y = 0; y < rect.height(); y++) {
+        for (int x = 0; x < rect.width(); x++) {
+            alphaImage.setPixel(x, y, qRgba(128, 128, 128, (x + y) / 2));
+        }
+    }
+
+    KisPaintDeviceSP alphaDev = new KisPaintDevice(cs);
+    alphaDev->setDefaultBounds(new TestUtil::TestingTimedDefaultBounds(rect));
+    alphaDev->convertFromQImage(alphaImage, 0, 0, 0);
+
+    {
+        KisTransaction transaction(alphaDev);
+        f->process(alphaDev, rect, kfc);
+    }
+
+    QImage alphaResult = alphaDev->convertToQImage(0, rect);
+    for (int y = 0; y < rect.height(); y++) {
+        for (int x = 0; x < rect.width(); x++) {
+            const int expectedAlpha = qAlpha(alphaImage.pixel(x, y));
+            const int actualAlpha = qAlpha(alphaResult.pixel(x, y));
+
+            if (qAbs(expectedAlpha - actualAlpha) > 1) {
+                QFAIL(QString("Alpha is not restored at %1,%2: %3 instead of %4")
+                      .arg(x).arg(y).arg(actualAlpha).arg(expectedAlpha).toLatin1());
+            }
+        }
+    }
+}
+
+void KisAllFilterTest::testLensBlurCircleInPatches()
+{
+    KisFilterSP f = KisFilterRegistry::instance()->value("lens blur");
+    QVERIFY(f);
+
+    KisFilterConfigurationSP kfc = f->defaultConfiguration();
+    kfc->setProperty("irisShape", "Circle");
+    kfc->setProperty("irisRadius", 9);
+
+    QVERIFY(testFilterInPatches(f, kfc));
+}
+
+void KisAllFilterTest::testLensBlurCircleUniform()
+{
+    KisFilterSP f = KisFilterRegistry::instance()->value("lens blur");
+    QVERIFY(f);
+
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    const QRect rect(0, 0, 100, 80);
+    const QColor color(200, 100, 50, 180);
+
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    dev->setDefaultBounds(new TestUtil::TestingTimedDefaultBounds(rect));
+    dev->fill(rect, KoColor(color, cs));
+
+    for (int quality = 1; quality <= 4; quality++) {
+        KisFilterConfigurationSP kfc = f->defaultConfiguration();
+        kfc->setProperty("irisShape", "Circle");
+        kfc->setProperty("irisRadius", 7);
+        kfc->setProperty("quality", quality);
+
+        {
+            KisTransaction transaction(dev);
+            f->process(dev, rect, kfc);
+        }
+
+        // the kernel is normalized and the edges are repeated, so
+        // a uniform image should stay the same
+        QImage expected(rect.size(), QImage::Format_ARGB32);
+        expected.fill(color);
+
+        QPoint errpoint;
+        QImage actualResult = dev->convertToQImage(0, rect);
+
+        if (!TestUtil::compareQImages(errpoint, expected, actualResult, 1, 1)) {
+            qDebug() << "Quality" << quality << "failed at" << errpoint;
+            QFAIL("Circle lens blur changed a uniform image");
+        }
+    }
+}
+
 
 
 QTEST_MAIN(KisAllFilterTest)
@@ -30,6 +30,11 @@ private Q_SLOTS:
     void testAllFilters();
     void testAllFiltersSrcNotIsDev();
     void testAllFiltersWithSelections();
+
+    void testPixelizeInPatches();
+    void testLensBlurCircleInPatches();
+    void testLensBlurCircleUniform();
+    void testHalftone();
 };
 
 #endif
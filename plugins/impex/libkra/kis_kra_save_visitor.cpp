@@ -90,6 +90,12 @@ void KisKraSaveVisitor::setExternalUri(const QString &uri)
     m_uri = uri;
 }
 
+void KisKraSaveVisitor::setAutosaveCaches(KisAutosaveCacheSP lastCache, KisAutosaveCacheSP pendingCache)
+{
+    m_lastAutosaveCache = lastCache;
+    m_pendingAutosaveCache = pendingCache;
+}
+
 bool KisKraSaveVisitor::visit(KisExternalLayer * layer)
 {
     bool result = false;
@@ -130,7 +136,7 @@ bool KisKraSaveVisitor::visit(KisExternalLayer * layer)
 
 bool KisKraSaveVisitor::visit(KisPaintLayer *layer)
 {
-    if (!savePaintDevice(layer->paintDevice(), getLocation(layer))) {
+    if (!savePaintDevice(layer->paintDevice(), getLocation(layer), layer->uuid().toString())) {
         m_errorMessages << i18n("Failed to save the pixel data for layer %1.", layer->name());
         return false;
     }
@@ -343,7 +349,8 @@ struct FramedDevicePolicy
 };
 
 bool KisKraSaveVisitor::savePaintDevice(KisPaintDeviceSP device,
-                                        QString location)
+                                        QString location,
+                                        const QString &cacheKey)
 {
     // Layer data
     KisConfig cfg(true);
@@ -357,7 +364,19 @@ bool KisKraSaveVisitor::savePaintDevice(KisPaintDeviceSP device,
     }
 
     if (!frameInterface || frames.count() <= 1) {
-        savePaintDeviceFrame(device, location, SimpleDevicePolicy());
+        if (cacheKey.isEmpty() || !m_pendingAutosaveCache) {
+            savePaintDeviceFrame(device, location, SimpleDevicePolicy());
+        } else {
+            bool result = false;
+
+            if (!copyUnchangedPaintDevice(device, location, cacheKey, &result)) {
+                result = savePaintDeviceFrame(device, location, SimpleDevicePolicy());
+            }
+
+            if (result) {
+                m_pendingAutosaveCache->addStream(cacheKey, device, location);
+            }
+        }
     } else {
         KisRasterKeyframeChannel *keyframeChannel = device->keyframeChannel();
 
@@ -398,6 +417,50 @@ bool KisKraSaveVisitor::savePaintDeviceFrame(KisPaintDeviceSP device, QString lo
     return true;
 }
 
+/**
+ * Copies the stream of \p device from the previous autosave file if the
+ * device hasn't been changed since then. Returns false if the stream
+ * should be saved in a usual way, otherwise the result of the copying
+ * is returned in \p result.
+ */
+bool KisKraSaveVisitor::copyUnchangedPaintDevice(KisPaintDeviceSP device, const QString &location, const QString &cacheKey, bool *result)
+{
+    if (!m_lastAutosaveCache) return false;
+
+    const QString lastLocation = m_lastAutosaveCache->unchangedStreamLocation(cacheKey, device);
+    if (lastLocation.isEmpty()) return false;
+
+    if (!m_lastAutosaveStore) {
+        m_lastAutosaveStore.reset(KoStore::createStore(m_lastAutosaveCache->filePath(), KoStore::Read, "", KoStore::Zip));
+    }
+
+    if (m_lastAutosaveStore->bad() || !m_lastAutosaveStore->open(lastLocation)) {
+        return false;
+    }
+
+    *result = m_store->open(location);
+
+    if (*result) {
+        const qint64 chunkSize = 1 << 20;
+
+        while (*result && !m_lastAutosaveStore->atEnd()) {
+            const QByteArray data = m_lastAutosaveStore->read(chunkSize);
+            *result = !data.isEmpty() && m_store->write(data) == data.size();
+        }
+
+        *result &= m_store->close();
+    }
+
+    m_lastAutosaveStore->close();
+
+    if (*result && m_store->open(location + ".defaultpixel")) {
+        m_store->write((char*)device->defaultPixel().data(), device->colorSpace()->pixelSize());
+        m_store->close();
+    }
+
+    return true;
+}
+
 bool KisKraSaveVisitor::saveAnnotations(KisLayer* layer)
 {
     if (!layer) return false;
@@ -448,7 +511,8 @@ bool KisKraSaveVisitor::saveSelection(KisNode* node)
 
     if (selection->hasPixelSelection()) {
         KisPaintDeviceSP dev = selection->pixelSelection();
-        if (!savePaintDevice(dev, getLocation(node, DOT_PIXEL_SELECTION))) {
+        if (!savePaintDevice(dev, getLocation(node, DOT_PIXEL_SELECTION),
+                             node->uuid().toString() + DOT_PIXEL_SELECTION)) {
             m_errorMessages << i18n("Failed to save the pixel selection data for layer %1.", node->name());
             retval = false;
         }
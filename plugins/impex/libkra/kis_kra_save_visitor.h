@@ -21,11 +21,13 @@
 #define KIS_KRA_SAVE_VISITOR_H_
 
 #include <QRect>
+#include <QScopedPointer>
 #include <QStringList>
 
 #include "kis_types.h"
 #include "kis_node_visitor.h"
 #include "kis_image.h"
+#include "KisAutosaveCache.h"
 #include "kritalibkra_export.h"
 
 class KisPaintDeviceWriter;
@@ -41,6 +43,14 @@ public:
 public:
     void setExternalUri(const QString &uri);
 
+    /**
+     * Makes the visitor copy the streams of the layers that haven't been
+     * changed since the previous autosave from the previous autosave file
+     * (described by \p lastCache) and record all the saved streams in
+     * \p pendingCache
+     */
+    void setAutosaveCaches(KisAutosaveCacheSP lastCache, KisAutosaveCacheSP pendingCache);
+
     bool visit(KisNode*) override {
         return true;
     }
@@ -72,7 +82,9 @@ public:
 
 private:
 
-    bool savePaintDevice(KisPaintDeviceSP device, QString location);
+    bool savePaintDevice(KisPaintDeviceSP device, QString location, const QString &cacheKey = QString());
+
+    bool copyUnchangedPaintDevice(KisPaintDeviceSP device, const QString &location, const QString &cacheKey, bool *result);
 
     template<class DevicePolicy>
     bool savePaintDeviceFrame(KisPaintDeviceSP device, QString location, DevicePolicy policy);
@@ -93,6 +105,9 @@ private:
     QMap<const KisNode*, QString> m_nodeFileNames;
     KisPaintDeviceWriter *m_writer;
     QStringList m_errorMessages;
+    KisAutosaveCacheSP m_lastAutosaveCache;
+    KisAutosaveCacheSP m_pendingAutosaveCache;
+    QScopedPointer<KoStore> m_lastAutosaveStore;
 };
 
 #endif // KIS_KRA_SAVE_VISITOR_H_
@@ -196,6 +196,10 @@ bool KisKraSaver::saveBinaryData(KoStore* store, KisImageSP image, const QString
     if (external)
         visitor.setExternalUri(uri);
 
+    if (autosave) {
+        visitor.setAutosaveCaches(m_d->doc->autosaveCache(), m_d->doc->pendingAutosaveCache());
+    }
+
     image->rootLayer()->accept(visitor);
 
     m_d->errorMessages.append(visitor.errorMessages());
@@ -540,4 +540,80 @@ void KisKraSaverTest::testRoundTripShapeSelection()
     QVERIFY(chk.testPassed());
 }
 
+/**
+ * Triggers an autosave of \p doc and waits until it is finished.
+ * Returns true if the autosave has succeeded.
+ */
+static bool autosaveAndWait(KisDocument *doc)
+{
+    doc->image()->waitForDone();
+    doc->setModified(true);
+
+    QMetaObject::invokeMethod(doc, "slotAutoSave");
+
+    while (doc->isSaving()) {
+        QTest::qWait(10);
+    }
+
+    return !doc->autosaveCache().isNull();
+}
+
+void KisKraSaverTest::testRoundTripAutosaveCache()
+{
+    QScopedPointer<KisDocument> doc(KisPart::instance()->createDocument());
+
+    QRect imageRect(0,0,512,512);
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(new KisSurrogateUndoStore(), imageRect.width(), imageRect.height(), cs, "test image");
+    KisPaintLayerSP changedLayer = new KisPaintLayer(image, "changed", OPACITY_OPAQUE_U8);
+    KisPaintLayerSP unchangedLayer = new KisPaintLayer(image, "unchanged", OPACITY_OPAQUE_U8);
+    image->addNode(changedLayer);
+    image->addNode(unchangedLayer);
+
+    changedLayer->paintDevice()->fill(QRect(100, 100, 150, 150), KoColor(Qt::red, cs));
+    unchangedLayer->paintDevice()->fill(QRect(10, 300, 400, 100), KoColor(Qt::blue, cs));
+    unchangedLayer->paintDevice()->fill(QRect(200, 20, 60, 300), KoColor(Qt::green, cs));
+
+    doc->setCurrentImage(image);
+
+    const QFileInfo fileInfo("roundtrip_autosave_cache.kra");
+    doc->setLocalFilePath(fileInfo.absoluteFilePath());
+    const QString autosavePath = fileInfo.absolutePath() + "/." + fileInfo.fileName() + "-autosave.kra";
+
+    QVERIFY(autosaveAndWait(doc.data()));
+
+    changedLayer->paintDevice()->fill(QRect(200, 200, 100, 100), KoColor(Qt::yellow, cs));
+    changedLayer->setDirty();
+
+    // only the modified layer should be saved again
+    KisAutosaveCacheSP cache = doc->autosaveCache();
+    QVERIFY(cache->unchangedStreamLocation(changedLayer->uuid().toString(), changedLayer->paintDevice()).isEmpty());
+    QVERIFY(!cache->unchangedStreamLocation(unchangedLayer->uuid().toString(), unchangedLayer->paintDevice()).isEmpty());
+
+    QVERIFY(autosaveAndWait(doc.data()));
+
+    QScopedPointer<KisDocument> doc2(KisPart::instance()->createDocument());
+    QVERIFY(doc2->loadNativeFormat(autosavePath));
+    doc2->image()->waitForDone();
+
+    QList<KisPaintLayerSP> layers;
+    layers << changedLayer << unchangedLayer;
+
+    Q_FOREACH (KisPaintLayerSP layer, layers) {
+        KisNodeSP node = TestUtil::findNode(doc2->image()->root(), layer->name());
+        QVERIFY(node);
+
+        QPoint errpoint;
+        const QImage expected = layer->paintDevice()->convertToQImage(0, imageRect);
+        const QImage loaded = node->paintDevice()->convertToQImage(0, imageRect);
+
+        if (!TestUtil::compareQImages(errpoint, expected, loaded)) {
+            QFAIL(QString("Failed to load the layer \"%1\" at %2,%3")
+                  .arg(layer->name()).arg(errpoint.x()).arg(errpoint.y()).toLatin1());
+        }
+    }
+
+    doc->removeAutoSaveFiles();
+}
+
 KISTEST_MAIN(KisKraSaverTest)
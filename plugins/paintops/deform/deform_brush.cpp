@@ -25,13 +25,18 @@
 #include <KoColorSpace.h>
 
 #include <QRect>
+#include <QScopedPointer>
+#include <QtMath>
 
 #include <kis_types.h>
 #include <kis_iterator_ng.h>
-#include <kis_cross_device_color_picker.h>
+#include <kis_random_accessor_ng.h>
+#include <kis_random_sub_accessor.h>
+#include <KoMixColorsOp.h>
 
 #include <cmath>
 #include <ctime>
+#include <limits>
 #include <KoColorSpaceRegistry.h>
 
 const qreal degToRad = M_PI / 180.0;
@@ -156,6 +161,90 @@ bool DeformBrush::setupAction(
     return true;
 }
 
+namespace {
+
+/**
+ * A contiguous copy of a rect of the source device. The deformed pixels
+ * are sampled from it exactly like KisRandomSubAccessor does, but
+ * without moving the random accessor between the tiles for every
+ * destination pixel.
+ */
+class DeformSourceCache
+{
+public:
+    DeformSourceCache(KisPaintDeviceSP device, const QRect &rect, bool useOldData)
+        : m_mixOp(device->colorSpace()->mixColorsOp()),
+          m_rect(rect),
+          m_pixelSize(device->pixelSize()),
+          m_rowStride(rect.width() * m_pixelSize),
+          m_data(rect.width() * rect.height() * m_pixelSize)
+    {
+        KisRandomConstAccessorSP it = device->createRandomConstAccessorNG(rect.x(), rect.y());
+        quint8 *dstPtr = m_data.data();
+
+        for (int y = rect.top(); y <= rect.bottom(); y++) {
+            int x = rect.left();
+
+            while (x <= rect.right()) {
+                it->moveTo(x, y);
+                const int columns = qMin(it->numContiguousColumns(x), rect.right() - x + 1);
+
+                memcpy(dstPtr, useOldData ? it->oldRawData() : it->rawDataConst(), columns * m_pixelSize);
+
+                dstPtr += columns * m_pixelSize;
+                x += columns;
+            }
+        }
+    }
+
+    inline bool canSample(qreal x, qreal y) const {
+        const int ix = (int)floor(x);
+        const int iy = (int)floor(y);
+
+        return ix >= m_rect.left() && ix < m_rect.right() &&
+            iy >= m_rect.top() && iy < m_rect.bottom();
+    }
+
+    inline void sample(qreal x, qreal y, quint8 *dst) const {
+        const quint8* pixels[4];
+        qint16 weights[4];
+
+        const int ix = (int)floor(x);
+        const int iy = (int)floor(y);
+        const double hsub = x - ix;
+        const double vsub = y - iy;
+
+        const quint8 *ptr = m_data.constData() +
+            (iy - m_rect.y()) * m_rowStride + (ix - m_rect.x()) * m_pixelSize;
+
+        weights[0] = qRound((1.0 - hsub) * (1.0 - vsub) * 255);
+        pixels[0] = ptr;
+        weights[1] = qRound((1.0 - vsub) * hsub * 255);
+        pixels[1] = ptr + m_pixelSize;
+        weights[2] = qRound(vsub * (1.0 - hsub) * 255);
+        pixels[2] = ptr + m_rowStride;
+        weights[3] = qRound(hsub * vsub * 255);
+        pixels[3] = ptr + m_rowStride + m_pixelSize;
+
+        m_mixOp->mixColors(pixels, weights, 4, dst);
+    }
+
+private:
+    const KoMixColorsOp *m_mixOp;
+    QRect m_rect;
+    int m_pixelSize;
+    int m_rowStride;
+    QVector<quint8> m_data;
+};
+
+enum DeformSampleType {
+    SampleOutside,
+    SampleSkipped,
+    SampleDeformed
+};
+
+}
+
 KisFixedPaintDeviceSP DeformBrush::paintMask(KisFixedPaintDeviceSP dab,
         KisPaintDeviceSP layer,
         qreal scale,
@@ -163,7 +252,6 @@ KisFixedPaintDeviceSP DeformBrush::paintMask(KisFixedPaintDeviceSP dab,
         QPointF pos, qreal subPixelX, qreal subPixelY, int dabX, int dabY)
 {
     KisFixedPaintDeviceSP mask = new KisFixedPaintDevice(KoColorSpaceRegistry::instance()->alpha8());
-    KisCrossDeviceColorPicker colorPicker(layer, dab);
 
     qreal fWidth = maskWidth(scale);
     qreal fHeight = maskHeight(scale);
@@ -202,8 +290,22 @@ KisFixedPaintDeviceSP DeformBrush::paintMask(KisFixedPaintDeviceSP dab,
     quint8* maskPointer = mask->data();
     qint8 maskPixelSize = mask->pixelSize();
 
-    quint8* dabPointer = dab->data();
-    int dabPixelSize = dab->colorSpace()->pixelSize();
+    /**
+     * First calculate the source position of every pixel of the dab,
+     * then read the source area in one go and sample it row by row.
+     * The random numbers are generated in the same order as before,
+     * so the result is exactly the same as sampling every pixel
+     * through the random sub accessor.
+     */
+    QVector<QPointF> samplePoints(dstWidth * dstHeight);
+    QVector<quint8> sampleTypes(dstWidth * dstHeight);
+    QPointF *samplePointer = samplePoints.data();
+    quint8 *typePointer = sampleTypes.data();
+
+    qreal samplesLeft = std::numeric_limits<qreal>::max();
+    qreal samplesTop = std::numeric_limits<qreal>::max();
+    qreal samplesRight = std::numeric_limits<qreal>::lowest();
+    qreal samplesBottom = std::numeric_limits<qreal>::lowest();
 
     for (int y = 0; y <  dstHeight; y++) {
         for (int x = 0; x < dstWidth; x++) {
@@ -214,9 +316,8 @@ KisFixedPaintDeviceSP DeformBrush::paintMask(KisFixedPaintDeviceSP dab,
 
             if (distance > 1.0) {
                 // leave there OPACITY TRANSPARENT pixel (default pixel)
-
-                colorPicker.pickOldColor(x + dabX, y + dabY, dabPointer);
-                dabPointer += dabPixelSize;
+                *samplePointer++ = QPointF(x + dabX, y + dabY);
+                *typePointer++ = SampleOutside;
 
                 *maskPointer = OPACITY_TRANSPARENT_U8;
                 maskPointer += maskPixelSize;
@@ -225,7 +326,9 @@ KisFixedPaintDeviceSP DeformBrush::paintMask(KisFixedPaintDeviceSP dab,
 
             if (m_sizeProperties->brush_density != 1.0) {
                 if (m_sizeProperties->brush_density < drand48()) {
-                    dabPointer += dabPixelSize;
+                    samplePointer++;
+                    *typePointer++ = SampleSkipped;
+
                     *maskPointer = OPACITY_TRANSPARENT_U8;
                     maskPointer += maskPixelSize;
                     continue;
@@ -243,26 +346,107 @@ KisFixedPaintDeviceSP DeformBrush::paintMask(KisFixedPaintDeviceSP dab,
                 maskY = qRound(maskY);
             }
 
-            if (m_properties->deform_use_old_data) {
-                colorPicker.pickOldColor(maskX, maskY, dabPointer);
-            }
-            else {
-                colorPicker.pickColor(maskX, maskY, dabPointer);
-            }
+            samplesLeft = qMin(samplesLeft, maskX);
+            samplesTop = qMin(samplesTop, maskY);
+            samplesRight = qMax(samplesRight, maskX);
+            samplesBottom = qMax(samplesBottom, maskY);
 
-            dabPointer += dabPixelSize;
+            *samplePointer++ = QPointF(maskX, maskY);
+            *typePointer++ = SampleDeformed;
 
             *maskPointer = OPACITY_OPAQUE_U8;
             maskPointer += maskPixelSize;
+        }
+    }
+
+    const QRect dabRect(dabX, dabY, dstWidth, dstHeight);
+
+    /**
+     * Some of the actions may throw the source position far away from
+     * the dab, such pixels are sampled through the sub accessor instead
+     */
+    const QRect limitRect = dabRect.adjusted(-dstWidth, -dstHeight, dstWidth, dstHeight);
+
+    QRect samplesRect;
+    if (samplesLeft <= samplesRight && samplesTop <= samplesBottom) {
+        samplesRect = QRect(QPoint(qFloor(qMax<qreal>(samplesLeft, limitRect.left())),
+                                   qFloor(qMax<qreal>(samplesTop, limitRect.top()))),
+                            QPoint(qFloor(qMin<qreal>(samplesRight, limitRect.right())) + 1,
+                                   qFloor(qMin<qreal>(samplesBottom, limitRect.bottom())) + 1));
+
+        if (!samplesRect.isValid()) {
+            samplesRect = QRect();
+        }
+    }
+
+    const bool useOldData = m_properties->deform_use_old_data;
+
+    DeformSourceCache oldDataCache(layer,
+                                   (useOldData ? samplesRect : QRect()) | dabRect.adjusted(0, 0, 1, 1),
+                                   true);
+    QScopedPointer<DeformSourceCache> newDataCache;
+    if (!useOldData && !samplesRect.isEmpty()) {
+        newDataCache.reset(new DeformSourceCache(layer, samplesRect, false));
+    }
+    const DeformSourceCache *deformedCache = useOldData ? &oldDataCache : newDataCache.data();
 
+    KisRandomSubAccessorSP subAccessor;
+
+    const KoColorSpace *srcColorSpace = layer->colorSpace();
+    const KoColorSpace *dstColorSpace = dab->colorSpace();
+    const int srcPixelSize = srcColorSpace->pixelSize();
+    const int dabRowStride = dstWidth * dstColorSpace->pixelSize();
+
+    QVector<quint8> rowBuffer(dstWidth * srcPixelSize);
+
+    samplePointer = samplePoints.data();
+    typePointer = sampleTypes.data();
+    quint8 *dabRowPointer = dab->data();
+
+    for (int y = 0; y < dstHeight; y++) {
+        quint8 *rowPointer = rowBuffer.data();
+
+        for (int x = 0; x < dstWidth; x++) {
+            const QPointF &pt = *samplePointer;
+
+            if (*typePointer == SampleOutside) {
+                oldDataCache.sample(pt.x(), pt.y(), rowPointer);
+            } else if (*typePointer == SampleDeformed) {
+                if (deformedCache && deformedCache->canSample(pt.x(), pt.y())) {
+                    deformedCache->sample(pt.x(), pt.y(), rowPointer);
+                } else {
+                    if (!subAccessor) {
+                        subAccessor = layer->createRandomSubAccessor();
+                    }
+
+                    subAccessor->moveTo(pt);
+                    if (useOldData) {
+                        subAccessor->sampledOldRawData(rowPointer);
+                    } else {
+                        subAccessor->sampledRawData(rowPointer);
+                    }
+                }
+            }
+
+            rowPointer += srcPixelSize;
+            samplePointer++;
+            typePointer++;
         }
+
+        srcColorSpace->convertPixelsTo(rowBuffer.constData(), dabRowPointer, dstColorSpace, dstWidth,
+                                       KoColorConversionTransformation::internalRenderingIntent(),
+                                       KoColorConversionTransformation::internalConversionFlags());
+
+        dabRowPointer += dabRowStride;
     }
+
     m_counter++;
 
     return mask;
 
 }
 
+
 void DeformBrush::debugColor(const quint8* data, KoColorSpace * cs)
 {
     QColor rgbcolor;
@@ -31,6 +31,7 @@
 #include <kis_random_accessor_ng.h>
 #include <kis_cross_device_color_picker.h>
 #include <kis_fixed_paint_device.h>
+#include <KisParticleSplatter.h>
 
 
 #include <cmath>
@@ -45,6 +46,7 @@ HairyBrush::HairyBrush()
 
     m_saturationId = -1;
     m_transfo = 0;
+    m_splatter = 0;
 }
 
 HairyBrush::~HairyBrush()
@@ -155,6 +157,14 @@ void HairyBrush::paintLine(KisPaintDeviceSP dab, KisPaintDeviceSP layer, const K
         }
     }
 
+    // antialiased bristles are written into the dab tile by tile at the end
+    KisParticleSplatter splatter(dab,
+                                 m_properties->useCompositing ?
+                                     KisParticleSplatter::Composite :
+                                     KisParticleSplatter::AddOpacity,
+                                 m_compositeOp);
+    m_splatter = &splatter;
+
     KisRandomSourceSP randomSource = pi2.randomSource();
 
     qreal fx1, fy1, fx2, fy2;
@@ -237,6 +247,10 @@ void HairyBrush::paintLine(KisPaintDeviceSP dab, KisPaintDeviceSP layer, const K
         }
 
     }
+
+    splatter.flush();
+    m_splatter = 0;
+
     m_dab = 0;
     m_dabAccessor = 0;
 }
@@ -337,27 +351,11 @@ void HairyBrush::paintParticle(QPointF pos, const KoColor& color, qreal weight)
     quint8 bbl = qRound((1.0 - fx) * (fy)  * opacity);
     quint8 bbr = qRound((fx)  * (fy)  * opacity);
 
-    const KoColorSpace * cs = m_dab->colorSpace();
-
-    m_dabAccessor->moveTo(ipx  , ipy);
-    btl = quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, btl + cs->opacityU8(m_dabAccessor->rawData()), OPACITY_OPAQUE_U8));
-    memcpy(m_dabAccessor->rawData(), color.data(), cs->pixelSize());
-    cs->setOpacity(m_dabAccessor->rawData(), btl, 1);
-
-    m_dabAccessor->moveTo(ipx + 1, ipy);
-    btr =  quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, btr + cs->opacityU8(m_dabAccessor->rawData()), OPACITY_OPAQUE_U8));
-    memcpy(m_dabAccessor->rawData(), color.data(), cs->pixelSize());
-    cs->setOpacity(m_dabAccessor->rawData(), btr, 1);
-
-    m_dabAccessor->moveTo(ipx, ipy + 1);
-    bbl = quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, bbl + cs->opacityU8(m_dabAccessor->rawData()), OPACITY_OPAQUE_U8));
-    memcpy(m_dabAccessor->rawData(), color.data(), cs->pixelSize());
-    cs->setOpacity(m_dabAccessor->rawData(), bbl, 1);
-
-    m_dabAccessor->moveTo(ipx + 1, ipy + 1);
-    bbr = quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, bbr + cs->opacityU8(m_dabAccessor->rawData()), OPACITY_OPAQUE_U8));
-    memcpy(m_dabAccessor->rawData(), color.data(), cs->pixelSize());
-    cs->setOpacity(m_dabAccessor->rawData(), bbr, 1);
+    // the opacities are added to the opacity of the dab pixels
+    m_splatter->addPixel(ipx  , ipy, color.data(), btl);
+    m_splatter->addPixel(ipx + 1, ipy, color.data(), btr);
+    m_splatter->addPixel(ipx, ipy + 1, color.data(), bbl);
+    m_splatter->addPixel(ipx + 1, ipy + 1, color.data(), bbr);
 }
 
 void HairyBrush::paintParticle(QPointF pos, const KoColor& color)
@@ -377,16 +375,16 @@ void HairyBrush::paintParticle(QPointF pos, const KoColor& color)
     quint8 bbr = qRound((fx)  * (fy)  * opacity);
 
     m_color.setOpacity(btl);
-    plotPixel(ipx  , ipy, m_color);
+    m_splatter->addPixel(ipx  , ipy, m_color.data());
 
     m_color.setOpacity(btr);
-    plotPixel(ipx + 1  , ipy, m_color);
+    m_splatter->addPixel(ipx + 1  , ipy, m_color.data());
 
     m_color.setOpacity(bbl);
-    plotPixel(ipx  , ipy + 1, m_color);
+    m_splatter->addPixel(ipx  , ipy + 1, m_color.data());
 
     m_color.setOpacity(bbr);
-    plotPixel(ipx + 1 , ipy + 1, m_color);
+    m_splatter->addPixel(ipx + 1 , ipy + 1, m_color.data());
 }
 
 
@@ -33,6 +33,7 @@
 #include <kis_random_accessor_ng.h>
 
 class KoCompositeOp;
+class KisParticleSplatter;
 
 
 class KisHairyProperties
@@ -93,6 +94,7 @@ private:
     /// check the opacity of dab pixel and if the opacity is less then color, it will copy color to dab
     void darkenPixel(int wx, int wy, const KoColor &color);
     /// paint wu particle by copying the color and setup just the opacity, weight is complementary to opacity of the color
+    /// (the pixels are written into the dab by the splatter at the end of paintLine())
     void paintParticle(QPointF pos, const KoColor& color, qreal weight);
     /// paint wu particle using composite operation
     void paintParticle(QPointF pos, const KoColor& color);
@@ -124,6 +126,7 @@ private:
     // temporary device
     KisPaintDeviceSP m_dab;
     KisRandomAccessorSP m_dabAccessor;
+    KisParticleSplatter *m_splatter;
     const KoCompositeOp * m_compositeOp;
     quint32 m_pixelSize;
 
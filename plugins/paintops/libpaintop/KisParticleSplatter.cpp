@@ -0,0 +1,113 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+#include "KisParticleSplatter.h"
+
+#include <algorithm>
+
+#include <KoColorSpace.h>
+#include <KoCompositeOp.h>
+
+#include "kis_paint_device.h"
+#include "kis_random_accessor_ng.h"
+
+
+KisParticleSplatter::KisParticleSplatter(KisPaintDeviceSP dev, Mode mode, const KoCompositeOp *compositeOp)
+    : m_dev(dev),
+      m_colorSpace(dev->colorSpace()),
+      m_mode(mode),
+      m_compositeOp(compositeOp),
+      m_pixelSize(dev->pixelSize())
+{
+    KIS_ASSERT_RECOVER(mode != Composite || compositeOp) {
+        m_mode = Overwrite;
+    }
+}
+
+KisParticleSplatter::~KisParticleSplatter()
+{
+    KIS_SAFE_ASSERT_RECOVER_NOOP(m_pixels.isEmpty());
+}
+
+void KisParticleSplatter::addPixel(int x, int y, const quint8 *color, quint8 opacity)
+{
+    const int lastOffset = m_colors.size() - m_pixelSize;
+
+    // the particles of a dab usually share the same color
+    if (lastOffset < 0 ||
+        memcmp(m_colors.constData() + lastOffset, color, m_pixelSize) != 0) {
+
+        m_colors.resize(m_colors.size() + m_pixelSize);
+        memcpy(m_colors.data() + m_colors.size() - m_pixelSize, color, m_pixelSize);
+    }
+
+    Pixel pixel;
+    pixel.x = x;
+    pixel.y = y;
+    pixel.colorOffset = m_colors.size() - m_pixelSize;
+    pixel.opacity = opacity;
+
+    m_pixels.append(pixel);
+}
+
+void KisParticleSplatter::flush()
+{
+    if (m_pixels.isEmpty()) return;
+
+    // equal to the size of the tiles of the data manager
+    const int tileShift = 6;
+
+    std::stable_sort(m_pixels.begin(), m_pixels.end(),
+        [] (const Pixel &lhs, const Pixel &rhs) {
+            const int lhsRow = lhs.y >> tileShift;
+            const int rhsRow = rhs.y >> tileShift;
+
+            return lhsRow < rhsRow ||
+                (lhsRow == rhsRow && (lhs.x >> tileShift) < (rhs.x >> tileShift));
+        });
+
+    KisRandomAccessorSP accessor =
+        m_dev->createRandomAccessorNG(m_pixels.first().x, m_pixels.first().y);
+
+    Q_FOREACH (const Pixel &pixel, m_pixels) {
+        accessor->moveTo(pixel.x, pixel.y);
+
+        quint8 *dst = accessor->rawData();
+        const quint8 *color = m_colors.constData() + pixel.colorOffset;
+
+        switch (m_mode) {
+        case Overwrite:
+            memcpy(dst, color, m_pixelSize);
+            break;
+        case AddOpacity: {
+            const quint8 opacity =
+                quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8,
+                                       pixel.opacity + m_colorSpace->opacityU8(dst),
+                                       OPACITY_OPAQUE_U8));
+            memcpy(dst, color, m_pixelSize);
+            m_colorSpace->setOpacity(dst, opacity, 1);
+            break;
+        }
+        case Composite:
+            m_compositeOp->composite(dst, m_pixelSize, color, m_pixelSize, 0, 0, 1, 1, OPACITY_OPAQUE_U8);
+            break;
+        }
+    }
+
+    m_pixels.clear();
+    m_colors.clear();
+}
@@ -0,0 +1,85 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+#ifndef KISPARTICLESPLATTER_H
+#define KISPARTICLESPLATTER_H
+
+#include <QVector>
+#include <KoColorSpaceConstants.h>
+#include "kis_types.h"
+#include "kritapaintop_export.h"
+
+class KoColorSpace;
+class KoCompositeOp;
+
+
+/**
+ * Collects the pixels of the tiny particles (or bristles) painted in
+ * a single dab and writes all of them into the device at once in
+ * flush(). The pixels are written in tile order, so the random accessor
+ * visits every tile only once instead of jumping between the tiles for
+ * every particle.
+ *
+ * The pixels are sorted with a stable sort, so the writes into the same
+ * pixel are applied in the order they were added and the result is exactly
+ * the same as if the pixels were written immediately.
+ */
+class PAINTOP_EXPORT KisParticleSplatter
+{
+public:
+    enum Mode {
+        Overwrite,  ///< the pixel is replaced with the color
+        AddOpacity, ///< the pixel is replaced with the color, the opacity is accumulated
+        Composite   ///< the color is composited onto the pixel with the composite op
+    };
+
+public:
+    KisParticleSplatter(KisPaintDeviceSP dev, Mode mode, const KoCompositeOp *compositeOp = 0);
+    ~KisParticleSplatter();
+
+    /**
+     * Schedules writing \p color into the pixel (\p x, \p y). In
+     * AddOpacity mode \p opacity is added to the opacity of the
+     * existing pixel and the result is assigned to the written pixel,
+     * in other modes it is ignored.
+     */
+    void addPixel(int x, int y, const quint8 *color, quint8 opacity = OPACITY_OPAQUE_U8);
+
+    /**
+     * Writes all the scheduled pixels into the device
+     */
+    void flush();
+
+private:
+    struct Pixel {
+        qint32 x;
+        qint32 y;
+        qint32 colorOffset;
+        quint8 opacity;
+    };
+
+    KisPaintDeviceSP m_dev;
+    const KoColorSpace *m_colorSpace;
+    Mode m_mode;
+    const KoCompositeOp *m_compositeOp;
+    int m_pixelSize;
+
+    QVector<Pixel> m_pixels;
+    QVector<quint8> m_colors;
+};
+
+#endif // KISPARTICLESPLATTER_H
@@ -19,7 +19,7 @@
 #include "particle_brush.h"
 
 #include "kis_paint_device.h"
-#include "kis_random_accessor_ng.h"
+#include "KisParticleSplatter.h"
 
 #include <KoColorSpace.h>
 #include <KoColor.h>
@@ -55,11 +55,10 @@ void ParticleBrush::setInitialPosition(const QPointF &pos)
 }
 
 
-void ParticleBrush::paintParticle(KisRandomAccessorSP accWrite, const KoColorSpace * cs, const QPointF &pos, const KoColor& color, qreal weight, bool respectOpacity)
+void ParticleBrush::paintParticle(KisParticleSplatter &splatter, const QPointF &pos, const KoColor& color, qreal weight, bool respectOpacity)
 {
     // opacity top left, right, bottom left, right
-    KoColor myColor(color);
-    quint8 opacity = respectOpacity ? myColor.opacityU8() : OPACITY_OPAQUE_U8;
+    quint8 opacity = respectOpacity ? color.opacityU8() : OPACITY_OPAQUE_U8;
 
     int ipx = floor(pos.x());
     int ipy = floor(pos.y());
@@ -71,21 +70,11 @@ void ParticleBrush::paintParticle(KisRandomAccessorSP accWrite, const KoColorSpa
     quint8 bbl = qRound((1.0 - fx) * (fy)  * opacity * weight);
     quint8 bbr = qRound((fx)  * (fy)  * opacity * weight);
 
-    accWrite->moveTo(ipx  , ipy);
-    myColor.setOpacity(quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, btl + cs->opacityU8(accWrite->rawData()), OPACITY_OPAQUE_U8)));
-    memcpy(accWrite->rawData(), myColor.data(), cs->pixelSize());
-
-    accWrite->moveTo(ipx + 1, ipy);
-    myColor.setOpacity(quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, btr + cs->opacityU8(accWrite->rawData()), OPACITY_OPAQUE_U8)));
-    memcpy(accWrite->rawData(), myColor.data(), cs->pixelSize());
-
-    accWrite->moveTo(ipx, ipy + 1);
-    myColor.setOpacity(quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, bbl + cs->opacityU8(accWrite->rawData()), OPACITY_OPAQUE_U8)));
-    memcpy(accWrite->rawData(), myColor.data(), cs->pixelSize());
-
-    accWrite->moveTo(ipx + 1, ipy + 1);
-    myColor.setOpacity(quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, bbr + cs->opacityU8(accWrite->rawData()), OPACITY_OPAQUE_U8)));
-    memcpy(accWrite->rawData(), myColor.data(), cs->pixelSize());
+    // the opacities are added to the opacity of the destination pixels
+    splatter.addPixel(ipx  , ipy, color.data(), btl);
+    splatter.addPixel(ipx + 1, ipy, color.data(), btr);
+    splatter.addPixel(ipx, ipy + 1, color.data(), bbl);
+    splatter.addPixel(ipx + 1, ipy + 1, color.data(), bbr);
 }
 
 
@@ -93,8 +82,7 @@ void ParticleBrush::paintParticle(KisRandomAccessorSP accWrite, const KoColorSpa
 
 void ParticleBrush::draw(KisPaintDeviceSP dab, const KoColor& color, const QPointF &pos)
 {
-    KisRandomAccessorSP accessor = dab->createRandomAccessorNG(qRound(pos.x()), qRound(pos.y()));
-    const KoColorSpace * cs = dab->colorSpace();
+    KisParticleSplatter splatter(dab, KisParticleSplatter::AddOpacity);
 
     QRect boundingRect;
 
@@ -141,11 +129,13 @@ void ParticleBrush::draw(KisPaintDeviceSP dab, const KoColor& color, const QPoin
             if (boundingRect.isEmpty() ||
                     boundingRect.contains(m_particlePos[j].toPoint())) {
 
-                paintParticle(accessor, cs, m_particlePos[j], color, m_properties->weight, true);
+                paintParticle(splatter, m_particlePos[j], color, m_properties->weight, true);
             }
 
         }//for j
     }//for i
+
+    splatter.flush();
 }
 
 
@@ -35,8 +35,7 @@ public:
     QPointF scale;
 };
 
-class KisRandomAccessor;
-class KoColorSpace;
+class KisParticleSplatter;
 class KoColor;
 
 class ParticleBrush
@@ -57,7 +56,7 @@ public:
 private:
     /// paints wu particle, similar to spray version but you can turn on respecting opacity of the tool and add weight to opacity
     /// also the particle respects opacity in the destination pixel buffer
-    void paintParticle(KisRandomAccessorSP writeAccessor, const KoColorSpace *cs,const QPointF &pos, const KoColor& color, qreal weight, bool respectOpacity);
+    void paintParticle(KisParticleSplatter &splatter, const QPointF &pos, const KoColor& color, qreal weight, bool respectOpacity);
 
     QVector<QPointF> m_particlePos;
     QVector<QPointF> m_particleNextPos;
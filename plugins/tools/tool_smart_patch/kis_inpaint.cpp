@@ -42,6 +42,8 @@
 //#include "kis_random_accessor_ng.h"
 
 #include <QList>
+#include <QThread>
+#include <QtConcurrent>
 #include <kis_transform_worker.h>
 #include <kis_filter_strategy.h>
 #include "KoColor.h"
@@ -248,7 +250,8 @@ private:
     MaskedImage() {}
 
 public:
-    std::function< float(const MaskedImage&, int, int, const MaskedImage& , int , int ) > distance;
+    typedef float (*DistanceFunction)(const MaskedImage&, int, int, const MaskedImage& , int , int );
+    DistanceFunction distance;
 
     void toPaintDevice(KisPaintDeviceSP imageDev, QRect rect)
     {
@@ -442,7 +445,7 @@ public:
         cs->fromNormalisedChannelsValue(imageData(x, y), value);
     }
 
-    inline void mixColors(std::vector< quint8* > pixels, std::vector< float > w, float wsum,  quint8* dst)
+    inline void mixColors(const std::vector< quint8* > &pixels, const std::vector< float > &w, float wsum,  quint8* dst)
     {
         const KoMixColorsOp* mixOp = cs->mixColorsOp();
 
@@ -483,13 +486,13 @@ public:
 template <typename T> float distance_impl(const MaskedImage& my, int x, int y, const MaskedImage& other, int xo, int yo)
 {
     float dsq = 0;
-    quint32 nchannels = my.channelCount();
-    quint8* v1 = my.imageData(x, y);
-    quint8* v2 = other.imageData(xo, yo);
+    const int nchannels = my.nChannels;
+    const T* v1 = reinterpret_cast<const T*>(my.imageData(x, y));
+    const T* v2 = reinterpret_cast<const T*>(other.imageData(xo, yo));
 
-    for (quint32 chan = 0; chan < nchannels; chan++) {
+    for (int chan = 0; chan < nchannels; chan++) {
         //It's very important not to lose precision in the next line
-        float v = ((float)(*((T*)v1 + chan)) - (float)(*((T*)v2 + chan)));
+        float v = ((float)v1[chan] - (float)v2[chan]);
         dsq += v * v;
     }
     return dsq / ( (float)KoColorSpaceMathsTraits<T>::unitValue * (float)KoColorSpaceMathsTraits<T>::unitValue / MAX_DIST );
@@ -611,30 +614,67 @@ public:
         initialize();
     }
 
+    //horizontal band of the field processed by a single thread
+    struct Band {
+        int top;
+        int bottom;
+        quint32 seed;
+    };
+
     //multi-pass NN-field minimization (see "PatchMatch" paper referenced above - page 4)
+    //
+    //The field is split into horizontal bands processed concurrently. Propagation
+    //reads the links of the previous (next) row, which may belong to a neighbour
+    //band, so even and odd bands are processed in two separate phases.
     void minimize(int pass)
     {
-        int min_x = 0;
-        int min_y = 0;
-        int max_x = imSize.width() - 1;
-        int max_y = imSize.height() - 1;
+        const int height = imSize.height();
+        const int bandHeight = qMax(16, height / (2 * QThread::idealThreadCount()) + 1);
 
         for (int i = 0; i < pass; i++) {
-            //scanline order
-            for (int y = min_y; y < max_y; y++)
-                for (int x = min_x; x <= max_x; x++)
-                    if (field[x][y].distance > 0)
-                        minimizeLink(x, y, 1);
+            //scanline order, then reverse scanline order
+            for (int dir = 1; dir >= -1; dir -= 2) {
+                for (int phase = 0; phase < 2; phase++) {
+                    QVector<Band> bands;
+
+                    for (int top = phase * bandHeight; top < height; top += 2 * bandHeight) {
+                        Band band;
+                        band.top = top;
+                        band.bottom = qMin(top + bandHeight, height) - 1;
+                        band.seed = rand();
+                        bands << band;
+                    }
+
+                    QtConcurrent::blockingMap(bands,
+                        [this, dir] (const Band &band) {
+                            minimizeBand(band, dir);
+                        });
+                }
+            }
+        }
+    }
+
+    void minimizeBand(const Band &band, int dir)
+    {
+        std::mt19937 generator(band.seed);
+
+        const int max_x = imSize.width() - 1;
+        const int max_y = imSize.height() - 1;
 
-            //reverse scanline order
-            for (int y = max_y; y >= min_y; y--)
-                for (int x = max_x; x >= min_x; x--)
+        if (dir > 0) {
+            for (int y = band.top; y <= band.bottom && y < max_y; y++)
+                for (int x = 0; x <= max_x; x++)
                     if (field[x][y].distance > 0)
-                        minimizeLink(x, y, -1);
+                        minimizeLink(x, y, 1, generator);
+        } else {
+            for (int y = band.bottom; y >= band.top; y--)
+                for (int x = max_x; x >= 0; x--)
+                    if (field[x][y].distance > 0)
+                        minimizeLink(x, y, -1, generator);
         }
     }
 
-    void minimizeLink(int x, int y, int dir)
+    void minimizeLink(int x, int y, int dir, std::mt19937 &generator)
     {
         int xp, yp, dp;
 
@@ -667,8 +707,8 @@ public:
         int xpi = field[x][y].x;
         int ypi = field[x][y].y;
         while (wi > 0) {
-            xp = xpi + randomInt(2 * wi) - wi;
-            yp = ypi + randomInt(2 * wi) - wi;
+            xp = xpi + int(generator() % (2 * wi)) - wi;
+            yp = ypi + int(generator() % (2 * wi)) - wi;
             xp = std::max(0, std::min(output->size().width() - 1, xp));
             yp = std::max(0, std::min(output->size().height() - 1, yp));
 
@@ -689,6 +729,12 @@ public:
         float wsum = 0;
         float ssdmax = nColors * 255 * 255;
 
+        const int inputWidth = input->size().width();
+        const int inputHeight = input->size().height();
+        const int outputWidth = output->size().width();
+        const int outputHeight = output->size().height();
+        const MaskedImage::DistanceFunction pixelDistance = input->distance;
+
         //for each pixel in the source patch
         for (int dy = -patchSize; dy <= patchSize; dy++) {
             for (int dx = -patchSize; dx <= patchSize; dx++) {
@@ -696,12 +742,12 @@ public:
                 int xks = x + dx;
                 int yks = y + dy;
 
-                if (xks < 0 || xks >= input->size().width()) {
+                if (xks < 0 || xks >= inputWidth) {
                     distance += ssdmax;
                     continue;
                 }
 
-                if (yks < 0 || yks >= input->size().height()) {
+                if (yks < 0 || yks >= inputHeight) {
                     distance += ssdmax;
                     continue;
                 }
@@ -715,11 +761,11 @@ public:
                 //corresponding pixel in target patch
                 int xkt = xp + dx;
                 int ykt = yp + dy;
-                if (xkt < 0 || xkt >= output->size().width()) {
+                if (xkt < 0 || xkt >= outputWidth) {
                     distance += ssdmax;
                     continue;
                 }
-                if (ykt < 0 || ykt >= output->size().height()) {
+                if (ykt < 0 || ykt >= outputHeight) {
                     distance += ssdmax;
                     continue;
                 }
@@ -731,7 +777,7 @@ public:
                 }
 
                 //SSD distance between pixels
-                float ssd = input->distance(*input, xks, yks, *output, xkt, ykt);
+                float ssd = pixelDistance(*input, xks, yks, *output, xkt, ykt);
                 distance += ssd;
 
             }
@@ -895,74 +941,85 @@ void NearestNeighborField::ExpectationStep(NearestNeighborFieldSP nnf, MaskedIma
     int H_source = source->size().height();
     int W_source = source->size().width();
 
-    std::vector< quint8* > pixels;
-    std::vector< float > weights;
-    pixels.reserve(R * R);
-    weights.reserve(R * R);
-    for (int x = 0 ; x < W_target ; ++x) {
-        for (int y = 0 ; y < H_target; ++y) {
-            float wsum = 0;
-            pixels.clear();
-            weights.clear();
-
-
-            if (!source->containsMasked(x, y, R + 4) /*&& upscale*/) {
-                //speedup computation by copying parts that are not masked.
-                pixels.push_back(source->getImagePixel(x, y));
-                weights.push_back(1.f);
-                target->mixColors(pixels, weights, 1.f, target->getImagePixel(x, y));
-            } else {
-                for (int dx = -R ; dx <= R; ++dx) {
-                    for (int dy = -R ; dy <= R ; ++dy) {
-                        // xpt,ypt = center pixel of the target patch
-                        int xpt = x + dx;
-                        int ypt = y + dy;
+    //every target pixel is voted independently, so the target is split into
+    //stripes of rows which are processed concurrently
+    const int stripeHeight = 32;
+    QVector<QRect> stripes;
+    for (int y = 0; y < H_target; y += stripeHeight) {
+        stripes << QRect(0, y, W_target, qMin(stripeHeight, H_target - y));
+    }
 
-                        int xst, yst;
-                        float w;
+    QtConcurrent::blockingMap(stripes, [&] (const QRect &stripe) {
+        std::vector< quint8* > pixels;
+        std::vector< float > weights;
+        pixels.reserve(R * R);
+        weights.reserve(R * R);
 
-                        if (!upscale) {
-                            if (xpt < 0 || xpt >= W_nnf || ypt < 0 || ypt >= H_nnf)
-                                continue;
+        for (int y = stripe.top(); y <= stripe.bottom(); ++y) {
+            for (int x = 0 ; x < W_target ; ++x) {
+                float wsum = 0;
+                pixels.clear();
+                weights.clear();
 
-                            xst = nnf->field[xpt][ypt].x;
-                            yst = nnf->field[xpt][ypt].y;
-                            float dp = nnf->field[xpt][ypt].distance;
-                            // similarity measure between the two patches
-                            w = nnf->similarity[dp];
 
-                        } else {
-                            if (xpt < 0 || (xpt / 2) >= W_nnf || ypt < 0 || (ypt / 2) >= H_nnf)
+                if (!source->containsMasked(x, y, R + 4) /*&& upscale*/) {
+                    //speedup computation by copying parts that are not masked.
+                    pixels.push_back(source->getImagePixel(x, y));
+                    weights.push_back(1.f);
+                    target->mixColors(pixels, weights, 1.f, target->getImagePixel(x, y));
+                } else {
+                    for (int dx = -R ; dx <= R; ++dx) {
+                        for (int dy = -R ; dy <= R ; ++dy) {
+                            // xpt,ypt = center pixel of the target patch
+                            int xpt = x + dx;
+                            int ypt = y + dy;
+
+                            int xst, yst;
+                            float w;
+
+                            if (!upscale) {
+                                if (xpt < 0 || xpt >= W_nnf || ypt < 0 || ypt >= H_nnf)
+                                    continue;
+
+                                xst = nnf->field[xpt][ypt].x;
+                                yst = nnf->field[xpt][ypt].y;
+                                float dp = nnf->field[xpt][ypt].distance;
+                                // similarity measure between the two patches
+                                w = nnf->similarity[dp];
+
+                            } else {
+                                if (xpt < 0 || (xpt / 2) >= W_nnf || ypt < 0 || (ypt / 2) >= H_nnf)
+                                    continue;
+                                xst = 2 * nnf->field[xpt / 2][ypt / 2].x + (xpt % 2);
+                                yst = 2 * nnf->field[xpt / 2][ypt / 2].y + (ypt % 2);
+                                float dp = nnf->field[xpt / 2][ypt / 2].distance;
+                                // similarity measure between the two patches
+                                w = nnf->similarity[dp];
+                            }
+
+                            int xs = xst - dx;
+                            int ys = yst - dy;
+
+                            if (xs < 0 || xs >= W_source || ys < 0 || ys >= H_source)
                                 continue;
-                            xst = 2 * nnf->field[xpt / 2][ypt / 2].x + (xpt % 2);
-                            yst = 2 * nnf->field[xpt / 2][ypt / 2].y + (ypt % 2);
-                            float dp = nnf->field[xpt / 2][ypt / 2].distance;
-                            // similarity measure between the two patches
-                            w = nnf->similarity[dp];
-                        }
-
-                        int xs = xst - dx;
-                        int ys = yst - dy;
-
-                        if (xs < 0 || xs >= W_source || ys < 0 || ys >= H_source)
-                            continue;
 
-                        if (source->isMasked(xs, ys))
-                            continue;
+                            if (source->isMasked(xs, ys))
+                                continue;
 
-                        pixels.push_back(source->getImagePixel(xs, ys));
-                        weights.push_back(w);
-                        wsum += w;
+                            pixels.push_back(source->getImagePixel(xs, ys));
+                            weights.push_back(w);
+                            wsum += w;
+                        }
                     }
-                }
 
-                if (wsum < 1)
-                    continue;
+                    if (wsum < 1)
+                        continue;
 
-                target->mixColors(pixels, weights, wsum, target->getImagePixel(x, y));
+                    target->mixColors(pixels, weights, wsum, target->getImagePixel(x, y));
+                }
             }
         }
-    }
+    });
 }
 
 QRect getMaskBoundingBox(KisPaintDeviceSP maskDev)
@@ -0,0 +1,70 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_inpaint_benchmark.h"
+
+#include <QTest>
+
+#include <KoColor.h>
+#include <KoColorSpaceRegistry.h>
+
+#include "kis_paint_device.h"
+#include "kis_painter.h"
+#include "kis_sequential_iterator.h"
+
+// defined in kis_inpaint.cpp
+QRect patchImage(KisPaintDeviceSP imageDev, KisPaintDeviceSP maskDev, int radius, int accuracy);
+
+void KisInpaintBenchmark::testPatchImage_data()
+{
+    QTest::addColumn<int>("maskSize");
+
+    QTest::newRow("64px") << 64;
+    QTest::newRow("256px") << 256;
+}
+
+void KisInpaintBenchmark::testPatchImage()
+{
+    QFETCH(int, maskSize);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    const QRect imageRect(0, 0, 4 * maskSize, 4 * maskSize);
+
+    // a periodic texture, so that the patches have something to match
+    KisPaintDeviceSP image = new KisPaintDevice(cs);
+    image->fill(imageRect, KoColor(Qt::white, cs));
+
+    KisSequentialIterator it(image, imageRect);
+    while (it.nextPixel()) {
+        quint8 *pixel = it.rawData();
+        pixel[0] = quint8((it.x() * 7) % 256);
+        pixel[1] = quint8((it.y() * 5) % 256);
+        pixel[2] = quint8(((it.x() + it.y()) * 3) % 256);
+    }
+
+    KisPaintDeviceSP mask = new KisPaintDevice(KoColorSpaceRegistry::instance()->alpha8());
+    mask->fill(QRect(imageRect.center() - QPoint(maskSize / 2, maskSize / 2), QSize(maskSize, maskSize)),
+               KoColor(Qt::black, mask->colorSpace()));
+
+    QBENCHMARK_ONCE {
+        KisPaintDeviceSP dev = new KisPaintDevice(*image);
+        patchImage(dev, mask, 4, 50);
+    }
+}
+
+QTEST_MAIN(KisInpaintBenchmark)
@@ -208,8 +208,13 @@ void KisPerspectiveTransformStrategy::paint(QPainter &gc)
     gc.save();
 
     gc.setOpacity(m_d->transaction.basePreviewOpacity());
-    gc.setTransform(m_d->paintingTransform, true);
-    gc.drawImage(m_d->paintingOffset, originalImage());
+
+    if (!paintRefinedPreview(gc, m_d->currentArgs,
+                             KisTransformUtils::imageToFlakeTransform(m_d->converter))) {
+
+        gc.setTransform(m_d->paintingTransform, true);
+        gc.drawImage(m_d->paintingOffset, originalImage());
+    }
 
     gc.restore();
 
@@ -57,6 +57,9 @@
 #include <kis_transaction.h>
 #include <kis_selection.h>
 #include <kis_filter_strategy.h>
+#include <kis_config.h>
+#include <kis_lod_transform.h>
+#include <kis_algebra_2d.h>
 #include <widgets/kis_cmb_idlist.h>
 #include <kis_statusbar.h>
 #include <kis_transform_worker.h>
@@ -114,6 +117,8 @@ KisToolTransform::KisToolTransform(KoCanvasBase * canvas)
             dynamic_cast<KisCanvas2*>(canvas)->coordinatesConverter(),
             dynamic_cast<KisCanvas2*>(canvas)->snapGuide(),
             m_currentArgs, m_transaction))
+    , m_previewCompressor(300, KisSignalCompressor::POSTPONE)
+    , m_previewSequenceNumber(new QAtomicInt(0))
 {
     m_canvas = dynamic_cast<KisCanvas2*>(canvas);
     Q_ASSERT(m_canvas);
@@ -152,6 +157,8 @@ KisToolTransform::KisToolTransform(KoCanvasBase * canvas)
 
     connect(&m_changesTracker, SIGNAL(sigConfigChanged()),
             this, SLOT(slotTrackerChangedConfig()));
+
+    connect(&m_previewCompressor, SIGNAL(timeout()), SLOT(slotRequestPreview()));
 }
 
 KisToolTransform::~KisToolTransform()
@@ -163,6 +170,7 @@ void KisToolTransform::outlineChanged()
 {
     emit freeTransformChanged();
     m_canvas->updateCanvas();
+    m_previewCompressor.start();
 }
 
 void KisToolTransform::canvasUpdateRequested()
@@ -212,6 +220,16 @@ void KisToolTransform::paint(QPainter& gc, const KoViewConverter &converter)
     if (m_refRect != newRefRect) {
         m_refRect = newRefRect;
         currentStrategy()->externalConfigChanged();
+        m_previewCompressor.start();
+    }
+
+    // the canvas has been scrolled out of the area of the refined preview
+    if (!m_refinedPreviewRect.isEmpty() &&
+        !m_refinedPreviewRect.contains(m_canvas->coordinatesConverter()->widgetRectInImagePixels().toAlignedRect())) {
+
+        m_refinedPreviewRect = QRect();
+        currentStrategy()->clearRefinedPreview();
+        m_previewCompressor.start();
     }
 
     gc.save();
@@ -790,6 +808,13 @@ void KisToolTransform::initThumbnailImage(KisPaintDeviceSP previewDevice)
     m_liquifyStrategy->setThumbnailImage(origImg, thumbToImageTransform);
 }
 
+void KisToolTransform::cancelPreviews()
+{
+    m_previewCompressor.stop();
+    m_previewSequenceNumber->fetchAndAddOrdered(1);
+    m_refinedPreviewRect = QRect();
+}
+
 void KisToolTransform::activate(ToolActivation toolActivation, const QSet<KoShape*> &shapes)
 {
     KisTool::activate(toolActivation, shapes);
@@ -935,6 +960,9 @@ void KisToolTransform::startStroke(ToolTransformArgs::TransformMode mode, bool f
         initTransformMode(mode);
     }
 
+    connect(strategy, SIGNAL(sigPreviewReady(int, const QImage&, const QTransform&)),
+            SLOT(slotPreviewReady(int, const QImage&, const QTransform&)));
+
     m_strokeData = StrokeData(image()->startStroke(strategy));
 
     bool haveInvisibleNodes = clearDevices(nodesList);
@@ -956,6 +984,8 @@ void KisToolTransform::endStroke()
 {
     if (!m_strokeData.strokeId()) return;
 
+    cancelPreviews();
+
     if (!m_currentArgs.isIdentity()) {
         transformClearedDevices();
 
@@ -980,6 +1010,8 @@ void KisToolTransform::cancelStroke()
 {
     if (!m_strokeData.strokeId()) return;
 
+    cancelPreviews();
+
     if (m_currentArgs.continuedTransform()) {
         m_currentArgs.restoreContinuedState();
         endStroke();
@@ -1221,6 +1253,53 @@ void KisToolTransform::slotEditingFinished()
     commitChanges();
 }
 
+void KisToolTransform::slotRequestPreview()
+{
+    if (!m_strokeData.strokeId()) return;
+
+    /**
+     * Liquify paints its own preview, and the points of warp and cage
+     * being edited do not define any transformation yet
+     */
+    if (m_currentArgs.mode() == ToolTransformArgs::LIQUIFY ||
+        m_currentArgs.isEditingTransformPoints()) {
+
+        return;
+    }
+
+    KisConfig cfg(true);
+    const int levelOfDetail =
+        KisLodTransform::scaleToLod(m_canvas->coordinatesConverter()->effectiveZoom(),
+                                    cfg.numMipmapLevels());
+
+    const QRect visibleRect =
+        KisAlgebra2D::blowRect(m_canvas->coordinatesConverter()->widgetRectInImagePixels(), 0.25).toAlignedRect();
+
+    const int sequenceNumber = m_previewSequenceNumber->fetchAndAddOrdered(1) + 1;
+    m_requestedPreviewArgs = m_currentArgs;
+    m_requestedPreviewRect = visibleRect;
+
+    image()->addJob(m_strokeData.strokeId(),
+                    new TransformStrokeStrategy::PreviewData(m_currentArgs,
+                                                             levelOfDetail,
+                                                             visibleRect,
+                                                             sequenceNumber,
+                                                             m_previewSequenceNumber));
+}
+
+void KisToolTransform::slotPreviewReady(int sequenceNumber, const QImage &image, const QTransform &previewToImage)
+{
+    if (!m_strokeData.strokeId() ||
+        sequenceNumber != m_previewSequenceNumber->load()) {
+
+        return;
+    }
+
+    currentStrategy()->setRefinedPreview(image, previewToImage, m_requestedPreviewArgs);
+    m_refinedPreviewRect = m_requestedPreviewRect;
+    m_canvas->updateCanvas();
+}
+
 void KisToolTransform::slotUpdateToWarpType()
 {
     setTransformMode(KisToolTransform::TransformToolMode::WarpTransformMode);
@@ -31,6 +31,8 @@
 #include <QVector3D>
 #include <QButtonGroup>
 #include <QPointer>
+#include <QSharedPointer>
+#include <QAtomicInt>
 
 #include <QKeySequence>
 
@@ -43,6 +45,7 @@
 #include <kis_tool.h>
 #include <kis_canvas2.h>
 #include <kis_action.h>
+#include <kis_signal_compressor.h>
 
 
 #include "tool_transform_args.h"
@@ -256,6 +259,7 @@ private:
     void initGuiAfterTransformMode();
 
     void initThumbnailImage(KisPaintDeviceSP previewDevice);
+    void cancelPreviews();
     void updateSelectionPath();
     void updateApplyResetAvailability();
 
@@ -332,6 +336,20 @@ private:
 
     QPainterPath m_cursorOutline;
 
+    /**
+     * The thumbnail preview is shown while the handles are moving. When
+     * they stop, a preview rendered by the real transform workers at
+     * the level of detail of the canvas is requested from the stroke.
+     * Bumping the sequence number cancels the requests in progress.
+     * The preview covers only the part of the image that was visible
+     * (with some margin) when it was requested.
+     */
+    KisSignalCompressor m_previewCompressor;
+    QSharedPointer<QAtomicInt> m_previewSequenceNumber;
+    ToolTransformArgs m_requestedPreviewArgs;
+    QRect m_requestedPreviewRect;
+    QRect m_refinedPreviewRect;
+
 private Q_SLOTS:
     void slotTrackerChangedConfig();
     void slotUiChangedConfig();
@@ -339,6 +357,8 @@ private Q_SLOTS:
     void slotResetTransform();
     void slotRestartTransform();
     void slotEditingFinished();
+    void slotRequestPreview();
+    void slotPreviewReady(int sequenceNumber, const QImage &image, const QTransform &previewToImage);
 
 
     // context menu options for updating the transform type
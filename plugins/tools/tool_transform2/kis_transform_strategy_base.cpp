@@ -20,13 +20,19 @@
 
 #include <QImage>
 #include <QTransform>
+#include <QPainter>
 #include "KoPointerEvent.h"
+#include "tool_transform_args.h"
 
 
 struct KisTransformStrategyBase::Private
 {
     QTransform thumbToImageTransform;
     QImage originalImage;
+
+    QImage refinedPreview;
+    QTransform refinedPreviewToImageTransform;
+    ToolTransformArgs refinedPreviewArgs;
 };
 
 
@@ -66,6 +72,36 @@ void KisTransformStrategyBase::setThumbnailImage(const QImage &image, QTransform
 {
     m_d->originalImage = image;
     m_d->thumbToImageTransform = thumbToImageTransform;
+
+    clearRefinedPreview();
+}
+
+void KisTransformStrategyBase::setRefinedPreview(const QImage &image, const QTransform &previewToImage, const ToolTransformArgs &args)
+{
+    m_d->refinedPreview = image;
+    m_d->refinedPreviewToImageTransform = previewToImage;
+    m_d->refinedPreviewArgs = args;
+}
+
+void KisTransformStrategyBase::clearRefinedPreview()
+{
+    m_d->refinedPreview = QImage();
+    m_d->refinedPreviewToImageTransform = QTransform();
+    m_d->refinedPreviewArgs = ToolTransformArgs();
+}
+
+bool KisTransformStrategyBase::paintRefinedPreview(QPainter &gc, const ToolTransformArgs &currentArgs, const QTransform &imageToFlake) const
+{
+    if (m_d->refinedPreview.isNull() || !(m_d->refinedPreviewArgs == currentArgs)) {
+        return false;
+    }
+
+    gc.save();
+    gc.setTransform(m_d->refinedPreviewToImageTransform * imageToFlake, true);
+    gc.drawImage(QPointF(), m_d->refinedPreview);
+    gc.restore();
+
+    return true;
 }
 
 bool KisTransformStrategyBase::acceptsClicks() const
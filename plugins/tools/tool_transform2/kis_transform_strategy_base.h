@@ -31,6 +31,7 @@ class QPainter;
 class QCursor;
 class KoPointerEvent;
 class QPainterPath;
+class ToolTransformArgs;
 
 
 class KisTransformStrategyBase : public QObject
@@ -44,6 +45,21 @@ public:
 
     void setThumbnailImage(const QImage &image, QTransform thumbToImageTransform);
 
+    /**
+     * Sets the preview rendered by the real transform workers for
+     * \p args. It is painted instead of the thumbnail until the
+     * arguments of the tool change.
+     */
+    void setRefinedPreview(const QImage &image, const QTransform &previewToImage, const ToolTransformArgs &args);
+    void clearRefinedPreview();
+
+    /**
+     * Paints the refined preview if it is valid for \p currentArgs
+     * \return false if there is no valid preview and the thumbnail
+     *         should be painted instead
+     */
+    bool paintRefinedPreview(QPainter &gc, const ToolTransformArgs &currentArgs, const QTransform &imageToFlake) const;
+
 public:
 
     virtual bool acceptsClicks() const;
@@ -209,6 +209,13 @@ bool KisTransformUtils::checkImageTooBig(const QRectF &bounds, const MatricesPac
 #include <kis_cage_transform_worker.h>
 #include <kis_liquify_transform_worker.h>
 
+namespace {
+KoUpdaterPtr fetchUpdater(KisProcessingVisitor::ProgressHelper *helper)
+{
+    return helper ? helper->updater() : KoUpdaterPtr();
+}
+}
+
 KisTransformWorker KisTransformUtils::createTransformWorker(const ToolTransformArgs &config,
                                                             KisPaintDeviceSP device,
                                                             KoUpdaterPtr updater,
@@ -250,7 +257,7 @@ void KisTransformUtils::transformDevice(const ToolTransformArgs &config,
                                         KisProcessingVisitor::ProgressHelper *helper)
 {
     if (config.mode() == ToolTransformArgs::WARP) {
-        KoUpdaterPtr updater = helper->updater();
+        KoUpdaterPtr updater = fetchUpdater(helper);
 
         KisWarpTransformWorker worker(config.warpType(),
                                       device,
@@ -260,7 +267,7 @@ void KisTransformUtils::transformDevice(const ToolTransformArgs &config,
                                       updater);
         worker.run();
     } else if (config.mode() == ToolTransformArgs::CAGE) {
-        KoUpdaterPtr updater = helper->updater();
+        KoUpdaterPtr updater = fetchUpdater(helper);
 
         KisCageTransformWorker worker(device,
                                       config.origPoints(),
@@ -271,15 +278,15 @@ void KisTransformUtils::transformDevice(const ToolTransformArgs &config,
         worker.setTransformedCage(config.transfPoints());
         worker.run();
     } else if (config.mode() == ToolTransformArgs::LIQUIFY) {
-        KoUpdaterPtr updater = helper->updater();
+        KoUpdaterPtr updater = fetchUpdater(helper);
         //FIXME:
         Q_UNUSED(updater);
 
         config.liquifyWorker()->run(device);
     } else {
         QVector3D transformedCenter;
-        KoUpdaterPtr updater1 = helper->updater();
-        KoUpdaterPtr updater2 = helper->updater();
+        KoUpdaterPtr updater1 = fetchUpdater(helper);
+        KoUpdaterPtr updater2 = fetchUpdater(helper);
 
         KisTransformWorker transformWorker =
             createTransformWorker(config, device, updater1, &transformedCenter);
@@ -92,6 +92,10 @@ public:
                                                     KoUpdaterPtr updater,
                                                     QVector3D *transformedCenter /* OUT */);
 
+    /**
+     * Transforms \p device according to \p config. The \p helper
+     * may be null if the progress should not be reported.
+     */
     static void transformDevice(const ToolTransformArgs &config,
                                 KisPaintDeviceSP device,
                                 KisProcessingVisitor::ProgressHelper *helper);
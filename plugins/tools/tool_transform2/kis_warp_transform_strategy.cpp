@@ -237,8 +237,14 @@ void KisWarpTransformStrategy::paint(QPainter &gc)
     gc.save();
 
     gc.setOpacity(m_d->transaction.basePreviewOpacity());
-    gc.setTransform(m_d->paintingTransform, true);
-    gc.drawImage(m_d->paintingOffset, m_d->transformedImage);
+
+    if (m_d->currentArgs.isEditingTransformPoints() ||
+        !paintRefinedPreview(gc, m_d->currentArgs,
+                             KisTransformUtils::imageToFlakeTransform(m_d->converter))) {
+
+        gc.setTransform(m_d->paintingTransform, true);
+        gc.drawImage(m_d->paintingOffset, m_d->transformedImage);
+    }
 
     gc.restore();
 
@@ -19,6 +19,7 @@
 #include "transform_stroke_strategy.h"
 
 #include <QMutexLocker>
+#include <QtMath>
 #include "kundo2commandextradata.h"
 
 #include "kis_node_progress_proxy.h"
@@ -29,6 +30,9 @@
 #include <kis_transaction.h>
 #include <kis_painter.h>
 #include <kis_transform_worker.h>
+#include <kis_perspectivetransform_worker.h>
+#include <kis_safe_transform.h>
+#include <krita_utils.h>
 #include <kis_transform_mask.h>
 #include "kis_transform_mask_adapter.h"
 #include "kis_transform_utils.h"
@@ -41,6 +45,8 @@
 #include "kis_sequential_iterator.h"
 #include "kis_selection_mask.h"
 #include "kis_image_config.h"
+#include "kis_lod_transform.h"
+#include <KoColorConversionTransformation.h>
 
 TransformStrokeStrategy::TransformStrokeStrategy(KisNodeSP rootNode,
                                                  KisNodeList processedNodes,
@@ -180,6 +186,7 @@ void TransformStrokeStrategy::doStrokeCallback(KisStrokeJobData *data)
 {
     TransformData *td = dynamic_cast<TransformData*>(data);
     ClearSelectionData *csd = dynamic_cast<ClearSelectionData*>(data);
+    PreviewData *pd = dynamic_cast<PreviewData*>(data);
 
     if(td) {
         m_savedTransformArgs = td->config;
@@ -276,11 +283,105 @@ void TransformStrokeStrategy::doStrokeCallback(KisStrokeJobData *data)
                                   KisStrokeJobData::SEQUENTIAL,
                                   KisStrokeJobData::NORMAL);
         }
+    } else if (pd) {
+        renderPreview(pd);
     } else {
         KisStrokeStrategyUndoCommandBased::doStrokeCallback(data);
     }
 }
 
+void TransformStrokeStrategy::renderPreview(const PreviewData *data)
+{
+    if (data->isOutdated()) return;
+
+    ToolTransformArgs config = data->config;
+
+    const bool isProjective =
+        config.mode() == ToolTransformArgs::FREE_TRANSFORM ||
+        config.mode() == ToolTransformArgs::PERSPECTIVE_4POINT;
+
+    const qreal scale = KisLodTransform::lodToScale(data->levelOfDetail);
+
+    KisPaintDeviceSP device;
+
+    /**
+     * For the projective transforms only the part of the source that is
+     * mapped into the visible rect is needed. The margin covers the
+     * support of the filters. Warp and cage workers always process the
+     * whole source grid, so they get the whole device.
+     */
+    if (isProjective) {
+        const QRect srcBounds = m_previewDevice->exactBounds();
+        const QTransform transform = KisTransformUtils::MatricesPack(config).finalTransform();
+        const int margin = qCeil(4.0 / scale);
+
+        KisSafeTransform safeTransform(transform, data->visibleRect | srcBounds, srcBounds);
+        const QRect srcRect =
+            safeTransform.mapRectBackward(data->visibleRect).adjusted(-margin, -margin, margin, margin) & srcBounds;
+
+        device = new KisPaintDevice(m_previewDevice->colorSpace());
+        if (!srcRect.isEmpty()) {
+            KisPainter::copyAreaOptimized(srcRect.topLeft(), m_previewDevice, device, srcRect);
+        }
+    } else {
+        device = new KisPaintDevice(*m_previewDevice);
+    }
+
+    /**
+     * The preview is rendered from the scaled down copy of the
+     * original, the arguments are scaled accordingly
+     */
+    if (data->levelOfDetail > 0) {
+        KisTransformWorker worker(device, scale, scale,
+                                  0, 0, 0, 0, 0, 0, 0,
+                                  0, config.filter());
+        worker.run();
+
+        config.scale3dSrcAndDst(scale);
+    }
+
+    if (data->isOutdated()) return;
+
+    const QRect visibleRect =
+        QTransform::fromScale(scale, scale).mapRect(QRectF(data->visibleRect)).toAlignedRect();
+
+    KisPaintDeviceSP dstDevice;
+
+    if (isProjective) {
+        /**
+         * Render only the visible rect, patch by patch, so that the job
+         * stops soon after the tool has requested a newer preview
+         */
+        KisPerspectiveTransformWorker worker(0, KisTransformUtils::MatricesPack(config).finalTransform(), 0);
+        dstDevice = new KisPaintDevice(device->colorSpace());
+
+        QVector<QRect> patches =
+            KritaUtils::splitRectIntoPatches(visibleRect, KritaUtils::optimalPatchSize());
+
+        Q_FOREACH (const QRect &patch, patches) {
+            if (data->isOutdated()) return;
+            worker.runPartialDst(device, dstDevice, patch);
+        }
+    } else {
+        KisTransformUtils::transformDevice(config, device, 0);
+        dstDevice = device;
+    }
+
+    if (data->isOutdated()) return;
+
+    const QRect rc = dstDevice->exactBounds() & visibleRect;
+    const QImage image =
+        dstDevice->convertToQImage(0, rc.x(), rc.y(), rc.width(), rc.height(),
+                                   KoColorConversionTransformation::internalRenderingIntent(),
+                                   KoColorConversionTransformation::internalConversionFlags());
+
+    const QTransform previewToImage =
+        QTransform::fromTranslate(rc.x(), rc.y()) *
+        QTransform::fromScale(1.0 / scale, 1.0 / scale);
+
+    emit sigPreviewReady(data->sequenceNumber, image, previewToImage);
+}
+
 void TransformStrokeStrategy::clearSelection(KisPaintDeviceSP device)
 {
     KisTransaction transaction(device);
@@ -19,7 +19,10 @@
 #ifndef __TRANSFORM_STROKE_STRATEGY_H
 #define __TRANSFORM_STROKE_STRATEGY_H
 
+#include <QObject>
 #include <QMutex>
+#include <QAtomicInt>
+#include <QSharedPointer>
 #include <KoUpdater.h>
 #include <kis_stroke_strategy_undo_command_based.h>
 #include <kis_types.h>
@@ -30,10 +33,13 @@
 
 
 class KisPostExecutionUndoAdapter;
+class QImage;
+class QTransform;
 
 
-class TransformStrokeStrategy : public KisStrokeStrategyUndoCommandBased
+class TransformStrokeStrategy : public QObject, public KisStrokeStrategyUndoCommandBased
 {
+    Q_OBJECT
 public:
     class TransformData : public KisStrokeJobData {
     public:
@@ -66,6 +72,38 @@ public:
         KisNodeSP node;
     };
 
+    /**
+     * Renders the preview of the transformation with the real transform
+     * workers at \p levelOfDetail. Only the part of the result inside
+     * \p visibleRect (in image coordinates) is rendered. The job is
+     * stopped (or its result is dropped) if the value of
+     * \p lastSequenceNumber is changed by the tool before the job is
+     * completed, so outdated previews do not occupy the workers.
+     */
+    class PreviewData : public KisStrokeJobData {
+    public:
+        PreviewData(const ToolTransformArgs &_config, int _levelOfDetail, const QRect &_visibleRect,
+                    int _sequenceNumber, QSharedPointer<QAtomicInt> _lastSequenceNumber)
+            : KisStrokeJobData(CONCURRENT, NORMAL),
+              config(_config),
+              levelOfDetail(_levelOfDetail),
+              visibleRect(_visibleRect),
+              sequenceNumber(_sequenceNumber),
+              lastSequenceNumber(_lastSequenceNumber)
+        {
+        }
+
+        bool isOutdated() const {
+            return lastSequenceNumber->load() != sequenceNumber;
+        }
+
+        ToolTransformArgs config;
+        int levelOfDetail;
+        QRect visibleRect;
+        int sequenceNumber;
+        QSharedPointer<QAtomicInt> lastSequenceNumber;
+    };
+
 public:
     TransformStrokeStrategy(KisNodeSP rootNode, KisNodeList processedNodes,
                             KisSelectionSP selection,
@@ -84,6 +122,14 @@ public:
 
     static bool fetchArgsFromCommand(const KUndo2Command *command, ToolTransformArgs *args, KisNodeSP *rootNode, KisNodeList *transformedNodes);
 
+Q_SIGNALS:
+    /**
+     * Emitted from the worker thread when the preview requested by
+     * PreviewData is ready. \p previewToImage maps the pixels of
+     * \p image into the image coordinates.
+     */
+    void sigPreviewReady(int sequenceNumber, const QImage &image, const QTransform &previewToImage);
+
 protected:
     void postProcessToplevelCommand(KUndo2Command *command) override;
 
@@ -99,6 +145,7 @@ private:
                          KisProcessingVisitor::ProgressHelper *helper);
 
     void clearSelection(KisPaintDeviceSP device);
+    void renderPreview(const PreviewData *data);
     //void transformDevice(KisPaintDeviceSP src, KisPaintDeviceSP dst, KisProcessingVisitor::ProgressHelper *helper);
 
     bool checkBelongsToSelection(KisPaintDeviceSP device) const;
@@ -281,6 +281,36 @@ void ToolTransformArgs::translate(const QPointF &offset)
     }
 }
 
+void ToolTransformArgs::scale3dSrcAndDst(qreal scale)
+{
+    if (m_mode == FREE_TRANSFORM || m_mode == PERSPECTIVE_4POINT) {
+        m_originalCenter *= scale;
+        m_rotationCenterOffset *= scale;
+        m_transformedCenter *= scale;
+
+        /**
+         * The perspective projection is invariant to scaling if the
+         * camera is moved by the same factor
+         */
+        m_cameraPos *= scale;
+
+        const QTransform S = QTransform::fromScale(scale, scale);
+        m_flattenedPerspectiveTransform = S.inverted() * m_flattenedPerspectiveTransform * S;
+    } else if(m_mode == WARP || m_mode == CAGE) {
+        for (auto &pt : m_origPoints) {
+            pt *= scale;
+        }
+
+        for (auto &pt : m_transfPoints) {
+            pt *= scale;
+        }
+    } else if (m_mode == LIQUIFY) {
+        KIS_ASSERT_RECOVER_NOOP(0 && "scaling of liquify transformation is not implemented");
+    } else {
+        KIS_ASSERT_RECOVER_NOOP(0 && "unknown transform mode");
+    }
+}
+
 bool ToolTransformArgs::isIdentity() const
 {
     if (m_mode == FREE_TRANSFORM) {
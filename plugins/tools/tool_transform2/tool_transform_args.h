@@ -275,6 +275,15 @@ public:
 
     void translate(const QPointF &offset);
 
+    /**
+     * Scales both the source and the destination of the transformation
+     * by \p scale, so that the arguments could be applied to a copy of
+     * the source device scaled by the same factor (e.g. for rendering a
+     * preview at a lower level of detail). Liquify arguments are not
+     * supported.
+     */
+    void scale3dSrcAndDst(qreal scale);
+
     void saveContinuedState();
     void restoreContinuedState();
     const ToolTransformArgs* continuedTransform() const;